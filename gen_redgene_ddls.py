@@ -71,6 +71,12 @@ for i in range(0, len(dgen_json['tables'])):
 				crt_tab_ddl = crt_tab_ddl+' number'
 				if(j != len(dgen_json['tables'][i]['columns'])-1):
 					crt_tab_ddl = crt_tab_ddl+','
+			elif(dgen_json['tables'][i]['columns'][j]['type'] == 'DECIMAL'):
+				precision = dgen_json['tables'][i]['columns'][j].get('precision', 18)
+				scale = dgen_json['tables'][i]['columns'][j].get('scale', min(2, precision))
+				crt_tab_ddl = crt_tab_ddl+' number('+str(precision)+','+str(scale)+')'
+				if(j != len(dgen_json['tables'][i]['columns'])-1):
+					crt_tab_ddl = crt_tab_ddl+','
 			elif(dgen_json['tables'][i]['columns'][j]['type'] == 'STRING'):
 				crt_tab_ddl = crt_tab_ddl+' varchar2('
 				if(dgen_json['tables'][i]['columns'][j].get('length') is not None):
@@ -4,13 +4,18 @@ namespace redgene
 {
     //Abstract Base Class for probablity distribution engines.
     template <typename disttype>
-    class prob_dist_base
+    class prob_dist_base : public arena_object
     {
     public:
         virtual void reset() = 0;
         virtual disttype operator()() = 0;
         virtual disttype min() const = 0;
         virtual disttype max() const = 0;
+        //position within the distribution; the prng state is saved separately
+        virtual void save_state(ostream& os) const = 0;
+        virtual void load_state(istream& is) = 0;
+        //moves a positional distribution to its n-th value, stateless ones ignore it
+        virtual void seek(uint_fast64_t position) = 0;
         virtual ~prob_dist_base() = default;
     };
 
@@ -49,26 +54,43 @@ namespace redgene
             return numeric_limits<disttype>::max();
         }
 
+        void save_state(ostream& os) const
+        {
+            os << value << ' ' << step << ' ' << minval;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> value >> step >> minval;
+        }
+
+        void seek(uint_fast64_t position)
+        {
+            value = minval + position * step;
+        }
+
     };
 
-    //uniform int number distribution
-    template <typename prngtype = uint_fast64_t, typename disttype = uint_fast64_t>
+    //uniform int number distribution; engine_type can name a concrete engine, so that the
+    //draws of a generation kernel are not virtual calls
+    template <typename prngtype = uint_fast64_t, typename disttype = uint_fast64_t,
+        typename engine_type = prng_engine<prngtype>>
     class uniform_int_dist_engine : public prob_dist_base<disttype>
     {
     private:
-        prng_engine<prngtype>& prng;
+        engine_type& prng;
         uniform_int_distribution<disttype>* uni_int_dist;  
     public:
-        uniform_int_dist_engine(prng_engine<prngtype>& prng, disttype a = 0, 
+        uniform_int_dist_engine(engine_type& prng, disttype a = 0, 
             disttype b = std::numeric_limits<disttype>::max()) : prng(prng),
-            uni_int_dist(new uniform_int_distribution<disttype>(a, b))
+            uni_int_dist(arena_new<uniform_int_distribution<disttype>>(a, b))
         {
         
         }
 
         ~uniform_int_dist_engine()
         {
-            delete uni_int_dist;
+            arena_delete(uni_int_dist);
         }
 
         void reset()
@@ -91,6 +113,21 @@ namespace redgene
             return uni_int_dist->max();
         }
 
+        void save_state(ostream& os) const
+        {
+            os << *uni_int_dist;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *uni_int_dist;
+        }
+
+        void seek(uint_fast64_t)
+        {
+
+        }
+
         void set_dist_params(disttype a, disttype b)
         {
             uni_int_dist->param(uniform_int_distribution<uint_fast64_t>::param_type(a, b));
@@ -107,14 +144,14 @@ namespace redgene
     public:
         uniform_real_dist_engine(prng_engine<prngtype>& prng, disttype a = 0.0,
             disttype b = 1.0) : prng(prng), 
-            uni_real_dist(new uniform_real_distribution<disttype>(a, b))
+            uni_real_dist(arena_new<uniform_real_distribution<disttype>>(a, b))
         {
 
         }
 
         ~uniform_real_dist_engine()
         {
-            delete uni_real_dist;
+            arena_delete(uni_real_dist);
         }
 
         void reset()
@@ -136,14 +173,30 @@ namespace redgene
         {
             return uni_real_dist->max();
         }
+
+        void save_state(ostream& os) const
+        {
+            os << *uni_real_dist;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *uni_real_dist;
+        }
+
+        void seek(uint_fast64_t)
+        {
+
+        }
     };
 
-    //zipfian distribution
-    template<typename prngtype = uint_fast64_t, typename disttype = uint_fast64_t>
+    //zipfian distribution, engine_type as for uniform_int_dist_engine
+    template<typename prngtype = uint_fast64_t, typename disttype = uint_fast64_t,
+        typename engine_type = prng_engine<prngtype>>
     class zipf_distribution : public prob_dist_base<disttype>
     {
     private:
-        prng_engine<prngtype>& prng;
+        engine_type& prng;
         disttype n;     ///< Number of elements
         double _s;    ///< Exponent
         double _q;    ///< Deformation
@@ -236,7 +289,7 @@ namespace redgene
         /// Zipf distribution for `N` items, in the range `[1,N]` inclusive.
         /// The distribution follows the power-law 1/(n+q)^s with exponent
         /// `s` and Hurwicz q-deformation `q`.
-        zipf_distribution(prng_engine<prngtype>& prng, 
+        zipf_distribution(engine_type& prng, 
             const disttype n=std::numeric_limits<disttype>::max(),
             const double s=1.0, const double q=0.0)
             : prng(prng), n(n), _s(s), _q(q), oms(1.0-s) , spole(abs(oms) < epsilon)
@@ -252,6 +305,21 @@ namespace redgene
 
         }
 
+        void save_state(ostream& os) const
+        {
+            os << dist;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> dist;
+        }
+
+        void seek(uint_fast64_t)
+        {
+
+        }
+
         inline disttype operator()()
         {
             while (true)
@@ -293,7 +361,7 @@ namespace redgene
             max_index(amount - 1)
         {
             assert(amount <= maxval);
-            set_dist_vector = new vector<disttype>(amount);
+            set_dist_vector = arena_new<vector<disttype>>(amount);
             set<disttype> is_used;
             uint_fast64_t track_n, track_mv = 0;
 	        uint_fast64_t idx = 0;
@@ -316,7 +384,7 @@ namespace redgene
         ~set_distribution()
         {
             if(set_dist_vector)
-                delete set_dist_vector;
+                arena_delete(set_dist_vector);
         }
 
         void reset()
@@ -334,6 +402,22 @@ namespace redgene
             return this->maxval;
         }
 
+        //the vector itself is rebuilt from the seed, only the fetch index moves
+        void save_state(ostream& os) const
+        {
+            os << current_fetch_index;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> current_fetch_index;
+        }
+
+        void seek(uint_fast64_t position)
+        {
+            current_fetch_index = position;
+        }
+
         inline disttype operator()()
         {
             disttype r;
@@ -358,4 +442,232 @@ namespace redgene
             return r;
         }
     };
+
+    //discrete distribution over the indices [0, n) of a weight vector, drawn in O(1) from
+    //Vose's alias table: one uniform real picks a slot and, by its fraction, either the slot
+    //or the slot's alias. Built in O(n) and needs no search, whatever the weights look like.
+    template<typename prngtype = uint_fast64_t, typename disttype = uint_fast64_t>
+    class alias_distribution : public prob_dist_base<disttype>
+    {
+    private:
+        prng_engine<prngtype>& prng;
+        vector<double> prob;
+        vector<disttype> alias;
+        uniform_real_distribution<double> dist;
+    public:
+        alias_distribution(prng_engine<prngtype>& prng, const vector<double>& weights) :
+            prng(prng), prob(weights.size(), 1.0), alias(weights.size()), dist(0, weights.size())
+        {
+            assert(weights.size() > 0);
+            double total = 0;
+            for(double weight : weights)
+                total += weight;
+
+            //weights scaled to a mean of 1, split into the slots below and above it
+            vector<double> scaled(weights.size());
+            vector<disttype> small, large;
+            for(size_t i = 0; i < weights.size(); ++i)
+            {
+                scaled[i] = weights[i] * weights.size() / total;
+                alias[i] = i;
+                (scaled[i] < 1.0 ? small : large).push_back(i);
+            }
+            //each small slot is topped up by a large one, which becomes its alias
+            while(!small.empty() && !large.empty())
+            {
+                disttype less = small.back(), more = large.back();
+                small.pop_back();
+                prob[less] = scaled[less];
+                alias[less] = more;
+                scaled[more] -= 1.0 - scaled[less];
+                if(scaled[more] < 1.0)
+                {
+                    large.pop_back();
+                    small.push_back(more);
+                }
+            }
+            //whatever is left is 1 up to rounding
+            for(disttype i : small)
+                prob[i] = 1.0;
+            for(disttype i : large)
+                prob[i] = 1.0;
+        }
+
+        void reset()
+        {
+            dist.reset();
+        }
+
+        disttype min() const
+        {
+            return 0;
+        }
+
+        disttype max() const
+        {
+            return prob.size() - 1;
+        }
+
+        void save_state(ostream& os) const
+        {
+            os << dist;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> dist;
+        }
+
+        void seek(uint_fast64_t)
+        {
+
+        }
+
+        inline disttype operator()()
+        {
+            double u = dist(prng);
+            disttype slot = std::min<disttype>(static_cast<disttype>(u), prob.size() - 1);
+            return (u - slot < prob[slot]) ? slot : alias[slot];
+        }
+    };
+
+    //pseudo random bijection of [0, n), a balanced Feistel network over the smallest even
+    //power of two domain holding n, walked until it lands back inside [0, n). The domain is
+    //less than 4n, so that takes under 4 rounds of the network on average. Keeps only its
+    //round keys, so any position maps in O(1) whatever n is.
+    class feistel_permutation
+    {
+    private:
+        static const unsigned int ROUNDS = 4;
+        uint_fast64_t n;
+        unsigned int half_bits = 1;
+        uint_fast64_t half_mask;
+        uint_fast64_t keys[ROUNDS];
+
+        inline uint_fast64_t encrypt(const uint_fast64_t x) const
+        {
+            uint_fast64_t left = x >> half_bits, right = x & half_mask;
+            for(unsigned int r = 0; r < ROUNDS; ++r)
+            {
+                uint_fast64_t next_right = left ^ (mix64(right ^ keys[r]) & half_mask);
+                left = right;
+                right = next_right;
+            }
+            return (left << half_bits) | right;
+        }
+    public:
+        feistel_permutation(const uint_fast64_t n, const uint_fast64_t seed) : n(n)
+        {
+            while(half_bits < 32 && (1ULL << (2 * half_bits)) < n)
+                ++half_bits;
+            half_mask = (1ULL << half_bits) - 1;
+            for(unsigned int r = 0; r < ROUNDS; ++r)
+                keys[r] = mix64(seed + r * 0x9E3779B97F4A7C15ULL);
+        }
+
+        inline uint_fast64_t operator()(uint_fast64_t x) const
+        {
+            do
+                x = encrypt(x);
+            while(x >= n);
+            return x;
+        }
+    };
+
+    //bijection of [0, n) that moves runs of run_length consecutive values as a whole: the
+    //runs are shuffled by a feistel_permutation and keep their order inside. A short last
+    //run stays at the end. A run_length of 1 shuffles every value.
+    class run_permutation
+    {
+    private:
+        uint_fast64_t run_length;
+        uint_fast64_t full_runs;
+        feistel_permutation run_order;
+    public:
+        run_permutation(const uint_fast64_t n, const uint_fast64_t run_length, const uint_fast64_t seed) :
+            run_length(run_length), full_runs(n / run_length), run_order(max<uint_fast64_t>(1, full_runs), seed)
+        {
+
+        }
+
+        inline uint_fast64_t operator()(const uint_fast64_t x) const
+        {
+            uint_fast64_t run = x / run_length;
+            if(run >= full_runs)
+                return x;
+            return run_order(run) * run_length + x % run_length;
+        }
+    };
+
+    //Bernoulli(p) bits, 64 at a time. A word whose bits are each set with probability p is
+    //built from the binary expansion of p: starting from the least significant 1, a random
+    //word is OR-ed in for every 1 and AND-ed in for every 0. That takes one random word per
+    //significant bit of p (at most PRECISION_BITS) instead of a draw and a branch per bit.
+    //Words are a function of (seed, stream, block) only, so any range can be filled in any order.
+    class bulk_bernoulli
+    {
+    private:
+        uint_fast64_t key;
+        uint_fast32_t expansion;
+        unsigned int bits;
+    public:
+        static const unsigned int PRECISION_BITS = 16;
+
+        bulk_bernoulli(const double p, const uint_fast64_t seed, const uint_fast32_t stream) :
+            key(mix64(seed ^ (static_cast<uint_fast64_t>(stream) << 32))),
+            expansion(static_cast<uint_fast32_t>(llround(p * (1u << PRECISION_BITS)))), 
+            bits(PRECISION_BITS)
+        {
+            //trailing zeros of the expansion need no random word
+            while(expansion && bits && !(expansion & 1))
+            {
+                expansion >>= 1;
+                --bits;
+            }
+        }
+
+        //bits of rows [64*block, 64*block + 64), row 64*block in the least significant bit
+        inline uint_fast64_t word(const uint_fast64_t block) const
+        {
+            if(expansion == 0)
+                return 0;
+            if(bits == 0)
+                return ~0ULL;
+            uint_fast64_t result = 0;
+            uint_fast64_t counter = key + block * bits * 0x9E3779B97F4A7C15ULL;
+            for(unsigned int i = 0; i < bits; ++i)
+            {
+                uint_fast64_t random_word = mix64(counter + i * 0x9E3779B97F4A7C15ULL);
+                result = ((expansion >> i) & 1) ? (result | random_word) : (result & random_word);
+            }
+            return result;
+        }
+
+        //bitmap of rows [first_row, first_row + rows), bit i for row first_row + i
+        void fill(vector<uint_fast64_t>& bitmap, const uint_fast64_t first_row, const uint_fast64_t rows) const
+        {
+            size_t words = (rows + 63) / 64;
+            bitmap.resize(words);
+            uint_fast64_t block = first_row >> 6;
+            unsigned int shift = first_row & 63;
+            uint_fast64_t current = word(block);
+            for(size_t w = 0; w < words; ++w)
+            {
+                if(shift == 0)
+                {
+                    bitmap[w] = current;
+                    if(w + 1 < words)
+                        current = word(block + w + 1);
+                }
+                else
+                {
+                    uint_fast64_t next = word(block + w + 1);
+                    bitmap[w] = (current >> shift) | (next << (64 - shift));
+                    current = next;
+                }
+            }
+            if(rows & 63)
+                bitmap.back() &= (1ULL << (rows & 63)) - 1;
+        }
+    };
 }
@@ -2,6 +2,14 @@
 
 namespace redgene
 {
+    //splitmix64 finalizer, a cheap stateless hash for counter keyed draws
+    inline uint_fast64_t mix64(uint_fast64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
     typedef enum random_engines
     {
         DEFAULT=1,
@@ -10,12 +18,13 @@ namespace redgene
         MT19937,
         MT19937_64,
         RANLUX24,
-        RANLUX48
+        RANLUX48,
+        PHILOX4X32
     } random_engines;
 
     //Abstract Base Class template
     template <typename UIntTypes>
-    class prng_base
+    class prng_base : public arena_object
     {
     public:
         virtual void seed(UIntTypes seed) = 0;
@@ -23,6 +32,18 @@ namespace redgene
         virtual void discard(unsigned long long t) = 0;
         virtual UIntTypes min() = 0;
         virtual UIntTypes max() = 0;
+        //textual engine state, used by checkpoint manifests
+        virtual void save_state(ostream& os) const = 0;
+        virtual void load_state(istream& is) = 0;
+        //counter based engines can be positioned on any (stream, position) in O(1)
+        virtual bool is_counter_based() const
+        {
+            return false;
+        }
+        virtual void seek(uint_fast64_t, uint_fast64_t)
+        {
+            throw runtime_error("prng engine does not support stream positioning!");
+        }
         virtual ~prng_base() = default;
     };
 
@@ -33,14 +54,14 @@ namespace redgene
         default_random_engine* def_prng;
     public:
         default_prng(UIntTypes seed = default_random_engine::default_seed) : 
-            def_prng(new default_random_engine(seed))
+            def_prng(arena_new<default_random_engine>(seed))
         {
 
         }
 
         ~default_prng()
         {
-            delete def_prng;
+            arena_delete(def_prng);
         }
 
         void seed(UIntTypes seed)
@@ -67,6 +88,16 @@ namespace redgene
         {
             return default_random_engine::max();
         }
+
+        void save_state(ostream& os) const
+        {
+            os << *def_prng;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *def_prng;
+        }
     };
 
     template <typename UIntTypes>
@@ -76,13 +107,13 @@ namespace redgene
         minstd_rand0* mstd0_prng;
     public:
         minstd0_prng(UIntTypes seed = minstd_rand0::default_seed) : 
-            mstd0_prng(new minstd_rand0(seed))
+            mstd0_prng(arena_new<minstd_rand0>(seed))
         {
 
         }
         ~minstd0_prng()
         {
-            delete mstd0_prng;
+            arena_delete(mstd0_prng);
         }
         void seed(UIntTypes seed)
         {
@@ -108,6 +139,16 @@ namespace redgene
         {
             return minstd_rand0::max();
         }
+
+        void save_state(ostream& os) const
+        {
+            os << *mstd0_prng;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *mstd0_prng;
+        }
     };
 
     template <typename UIntTypes>
@@ -117,13 +158,13 @@ namespace redgene
         minstd_rand* mstd_prng;
     public:
         minstd1_prng(UIntTypes seed = minstd_rand::default_seed) : 
-            mstd_prng(new minstd_rand(seed))
+            mstd_prng(arena_new<minstd_rand>(seed))
         {
 
         }
         ~minstd1_prng()
         {
-            delete mstd_prng;
+            arena_delete(mstd_prng);
         }
         void seed(UIntTypes seed)
         {
@@ -149,6 +190,16 @@ namespace redgene
         {
             return minstd_rand::max();
         }
+
+        void save_state(ostream& os) const
+        {
+            os << *mstd_prng;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *mstd_prng;
+        }
     };
 
     template <typename UIntTypes>
@@ -158,13 +209,13 @@ namespace redgene
         mt19937* mt_prng;
     public:
         mt19937_prng(UIntTypes seed = mt19937::default_seed) : 
-            mt_prng(new mt19937(seed))
+            mt_prng(arena_new<mt19937>(seed))
         {
 
         }
         ~mt19937_prng()
         {
-            delete mt_prng;
+            arena_delete(mt_prng);
         }
         void seed(UIntTypes seed)
         {
@@ -190,6 +241,16 @@ namespace redgene
         {
             return mt19937::max();
         }
+
+        void save_state(ostream& os) const
+        {
+            os << *mt_prng;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *mt_prng;
+        }
     };
 
     template <typename UIntTypes>
@@ -199,13 +260,13 @@ namespace redgene
         ranlux24_base* rl24_prng;
     public:
         ranlux24_prng(UIntTypes seed = ranlux24_base::default_seed) : 
-            rl24_prng(new ranlux24_base(seed))
+            rl24_prng(arena_new<ranlux24_base>(seed))
         {
 
         }
         ~ranlux24_prng()
         {
-            delete rl24_prng;
+            arena_delete(rl24_prng);
         }
         void seed(UIntTypes seed)
         {
@@ -231,6 +292,16 @@ namespace redgene
         {
             return ranlux24_base::max();
         }
+
+        void save_state(ostream& os) const
+        {
+            os << *rl24_prng;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *rl24_prng;
+        }
     };
 
     #pragma GCC diagnostic push
@@ -243,13 +314,13 @@ namespace redgene
         mt19937_64* mt64_prng;
     public:
         mt19937_64_prng(UIntTypes seed = mt19937_64::default_seed) : 
-            mt64_prng(new mt19937_64(seed))
+            mt64_prng(arena_new<mt19937_64>(seed))
         {
 
         }
         ~mt19937_64_prng()
         {
-            delete mt64_prng;
+            arena_delete(mt64_prng);
         }
         void seed(UIntTypes seed)
         {
@@ -275,6 +346,16 @@ namespace redgene
         {
             return mt19937_64::max();
         }
+
+        void save_state(ostream& os) const
+        {
+            os << *mt64_prng;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *mt64_prng;
+        }
     };
 
     template <typename UIntTypes>
@@ -284,13 +365,13 @@ namespace redgene
         ranlux48_base* rl48_prng;
     public:
         ranlux48_prng(UIntTypes seed = ranlux48_base::default_seed) : 
-            rl48_prng(new ranlux48_base(seed))
+            rl48_prng(arena_new<ranlux48_base>(seed))
         {
 
         }
         ~ranlux48_prng()
         {
-            delete rl48_prng;
+            arena_delete(rl48_prng);
         }
         void seed(UIntTypes seed)
         {
@@ -316,10 +397,144 @@ namespace redgene
         {
             return ranlux48_base::max();
         }
+
+        void save_state(ostream& os) const
+        {
+            os << *rl48_prng;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> *rl48_prng;
+        }
     };
 
     #pragma GCC diagnostic pop
 
+    //Philox4x32-10 counter based engine (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+    //Every output is a pure function of the key and a 128 bit counter, the counter is laid out as
+    //{word block, position lo, position hi, stream} so that each (stream, position) pair owns its
+    //own sequence of 2^32 blocks and can be reached without generating anything before it.
+    template <typename UIntTypes>
+    class philox4x32_prng final : public prng_base<UIntTypes>
+    {
+    private:
+        uint32_t key[2];
+        uint32_t ctr[4];
+        uint32_t out[4];
+        uint_fast8_t out_idx = 4;
+
+        static const uint32_t mult0 = 0xD2511F53;
+        static const uint32_t mult1 = 0xCD9E8D57;
+        static const uint32_t weyl0 = 0x9E3779B9;
+        static const uint32_t weyl1 = 0xBB67AE85;
+
+        void generate_block()
+        {
+            uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+            uint32_t k0 = key[0], k1 = key[1];
+            for(uint_fast8_t round = 0; round < 10; ++round)
+            {
+                uint64_t p0 = static_cast<uint64_t>(mult0) * c0;
+                uint64_t p1 = static_cast<uint64_t>(mult1) * c2;
+                c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+                c1 = static_cast<uint32_t>(p1);
+                c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+                c3 = static_cast<uint32_t>(p0);
+                k0 += weyl0;
+                k1 += weyl1;
+            }
+            out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+            increment_counter(1);
+            out_idx = 0;
+        }
+
+        void increment_counter(uint64_t blocks)
+        {
+            uint64_t lo = (static_cast<uint64_t>(ctr[1]) << 32 | ctr[0]) + blocks;
+            if(lo < blocks && ++ctr[2] == 0)
+                ++ctr[3];
+            ctr[0] = static_cast<uint32_t>(lo);
+            ctr[1] = static_cast<uint32_t>(lo >> 32);
+        }
+    public:
+        philox4x32_prng(UIntTypes seed = 1729)
+        {
+            this->seed(seed);
+        }
+
+        void seed(UIntTypes seed)
+        {
+            key[0] = static_cast<uint32_t>(seed);
+            key[1] = static_cast<uint32_t>(static_cast<uint64_t>(seed) >> 32);
+            ctr[0] = ctr[1] = ctr[2] = ctr[3] = 0;
+            out_idx = 4;
+        }
+
+        inline UIntTypes operator()()
+        {
+            if(out_idx == 4)
+                generate_block();
+            return out[out_idx++];
+        }
+
+        void discard(unsigned long long t)
+        {
+            for(; t > 0 && out_idx < 4; --t)
+                ++out_idx;
+            if(t == 0)
+                return;
+            increment_counter(t / 4);
+            if(t % 4)
+            {
+                generate_block();
+                out_idx = t % 4;
+            }
+        }
+
+        UIntTypes min()
+        {
+            return 0;
+        }
+
+        UIntTypes max()
+        {
+            return 0xFFFFFFFF;
+        }
+
+        void save_state(ostream& os) const
+        {
+            os << key[0] << ' ' << key[1];
+            for(uint_fast8_t i = 0; i < 4; ++i)
+                os << ' ' << ctr[i] << ' ' << out[i];
+            os << ' ' << static_cast<unsigned>(out_idx);
+        }
+
+        void load_state(istream& is)
+        {
+            unsigned idx;
+            is >> key[0] >> key[1];
+            for(uint_fast8_t i = 0; i < 4; ++i)
+                is >> ctr[i] >> out[i];
+            is >> idx;
+            out_idx = idx;
+        }
+
+        bool is_counter_based() const
+        {
+            return true;
+        }
+
+        void seek(uint_fast64_t stream, uint_fast64_t position)
+        {
+            ctr[0] = 0;
+            ctr[1] = static_cast<uint32_t>(position);
+            ctr[2] = static_cast<uint32_t>(position >> 32);
+            ctr[3] = static_cast<uint32_t>(stream);
+            out_idx = 4;
+        }
+    };
+
     template <typename UIntTypes>
     class prng_engine
     {
@@ -355,6 +570,9 @@ namespace redgene
                 case RANLUX48:
                     p1 = new ranlux48_prng<UIntTypes>(seed);
                     break;
+                case PHILOX4X32:
+                    p1 = new philox4x32_prng<UIntTypes>(seed);
+                    break;
                 default:
                     p1 = new default_prng<UIntTypes>(seed);
             }
@@ -381,6 +599,12 @@ namespace redgene
             p1->seed(seed);
         }
 
+        //the engine behind get_rand_engine(), for code specialized on its concrete type
+        prng_base<UIntTypes>& get_base()
+        {
+            return *p1;
+        }
+
         inline UIntTypes operator()()
         {
             return (*p1)();
@@ -397,6 +621,22 @@ namespace redgene
         {
             return p1->max();
         }
+        void save_state(ostream& os) const
+        {
+            p1->save_state(os);
+        }
+        void load_state(istream& is)
+        {
+            p1->load_state(is);
+        }
+        bool is_counter_based() const
+        {
+            return p1->is_counter_based();
+        }
+        void seek(uint_fast64_t stream, uint_fast64_t position)
+        {
+            p1->seek(stream, position);
+        }
         ~prng_engine()
         {
             delete p1;
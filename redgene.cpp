@@ -4,21 +4,210 @@ using namespace redgene;
 
 int main(int argc, char** argv)
 {
-    if(argc != 2)
+    //redgene profile <file> [--table <name>]: schema template profiled from a '|' delimited file
+    if(argc > 2 && string(argv[1]) == "profile")
     {
-        cout << "Insufficient arguments; redgene <schema_template.json>" << endl;
+        string table_name;
+        if(argc > 4 && string(argv[3]) == "--table")
+            table_name = argv[4];
+        try
+        {
+            redgene_profiler rg_profiler(argv[2], table_name);
+            rg_profiler.report(cout);
+        }
+        catch(const std::exception& e)
+        {
+            cerr << e.what() << endl;
+            return EXIT_FAILURE;
+        }
         return EXIT_SUCCESS;
     }
-    redgene_validator rg_validator(argv[1]);
 
-    cout << (rg_validator.is_valid() ? "VALID" : "INVALID!") << endl;
-    
+    bool resume = false;
+    string schema_template;
+    string rows_spec;
+    string output_spec;
+    string writer_mode;
+    bool print_stats = false;
+    bool dry_run = false;
+    bool plan = false;
+    string memory_budget_spec;
+    string scale_spec;
+    string compile_spec;
+    string seed_spec;
+    string seeds_spec;
+    vector<string> append_specs;
+
+    //redgene verify ... <schema_template.json>: checks the generated files against the schema
+    bool verify = argc > 1 && string(argv[1]) == "verify";
+    for(int i = verify ? 2 : 1; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        if(arg == "--resume")
+            resume = true;
+        else if(arg == "--rows" && i + 1 < argc)
+            rows_spec = argv[++i];
+        else if(arg == "--output" && i + 1 < argc)
+            output_spec = argv[++i];
+        else if(arg == "--writer" && i + 1 < argc)
+            writer_mode = argv[++i];
+        else if(arg == "--stats")
+            print_stats = true;
+        else if(arg == "--scale" && i + 1 < argc)
+            scale_spec = argv[++i];
+        else if(arg == "--dry-run")
+            dry_run = true;
+        else if(arg == "--plan")
+            plan = true;
+        else if(arg == "--memory-budget" && i + 1 < argc)
+            memory_budget_spec = argv[++i];
+        else if(arg == "--compile" && i + 1 < argc)
+            compile_spec = argv[++i];
+        else if(arg == "--seed" && i + 1 < argc)
+            seed_spec = argv[++i];
+        else if(arg == "--seeds" && i + 1 < argc)
+            seeds_spec = argv[++i];
+        else if(arg == "--append" && i + 1 < argc)
+            append_specs.push_back(argv[++i]);
+        else
+            schema_template = arg;
+    }
+
+    if(schema_template.empty())
+    {
+        cout << "Insufficient arguments; redgene [--resume] [--rows table:start-end] "
+            "[--output -|fifo:<path>|sqlite:<path>|<path>] [--writer buffered|direct] [--stats] "
+            "[--scale <factor>] [--seed <seed>|--seeds <first>..<last>] [--append table:rows]... "
+            "[--dry-run] [--plan [--memory-budget <MB>]] "
+            "[--compile <plan.rgp>] <schema_template.json|plan.rgp>" << endl;
+        cout << "                        redgene profile <file.csv> [--table <name>]" << endl;
+        cout << "                        redgene verify [--scale <factor>] [--output <path>] "
+            "<schema_template.json>" << endl;
+        return EXIT_SUCCESS;
+    }
+    redgene_validator rg_validator(schema_template);
+
+    //--rows and the "-" output write data to stdout, keep the status messages out of it
+    bool data_on_stdout = !rows_spec.empty() || output_spec == "-";
+    if(rg_validator.is_valid() && output_spec.empty())
+    {
+        json& rg_json = rg_validator.get_redgene_valid_json();
+        data_on_stdout |= rg_json.find("output") != rg_json.end() && 
+            rg_json.find("output").value().get<string>() == "-";
+    }
+    ostream& status = data_on_stdout ? cerr : cout;
+    status << (rg_validator.is_valid() ? "VALID" : "INVALID!") << endl;
+    for(auto& error : rg_validator.get_errors())
+        cerr << "  " << error << endl;
+
     if(rg_validator.is_valid())
     {
         redgene_engine rg_engine(rg_validator);
-        rg_engine.generate(); 
-        cout << "Data Generated Successfully." << endl;
-    } 
-    
+        try
+        {
+            if(!scale_spec.empty())
+                rg_engine.set_scale_factor(stod(scale_spec));
+            if(!seed_spec.empty())
+                rg_engine.set_seed(stoull(seed_spec));
+            if(!seeds_spec.empty() && (!seed_spec.empty() || !rows_spec.empty() || !compile_spec.empty() ||
+                dry_run || verify || plan))
+                throw runtime_error("--seeds only generates data, it does not combine with --seed, --rows, "
+                    "--compile, --dry-run, --plan or verify");
+            for(auto& append_spec : append_specs)
+            {
+                auto colon = append_spec.rfind(':');
+                if(colon == string::npos)
+                    throw runtime_error("--append expects table:rows");
+                rg_engine.set_append(append_spec.substr(0, colon), stoull(append_spec.substr(colon + 1)));
+            }
+            if(!compile_spec.empty())
+            {
+                rg_engine.compile(compile_spec);
+                cout << "Plan compiled to " << compile_spec << endl;
+                return EXIT_SUCCESS;
+            }
+            if(dry_run)
+            {
+                rg_engine.dry_run(cout);
+                return EXIT_SUCCESS;
+            }
+            if(verify)
+            {
+                redgene_verifier rg_verifier(rg_engine, output_spec);
+                return rg_verifier.report(cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+            if(plan)
+            {
+                redgene_planner rg_planner(rg_engine);
+                if(!memory_budget_spec.empty())
+                    rg_planner.set_memory_budget(stod(memory_budget_spec));
+                rg_planner.report(cout);
+                return EXIT_SUCCESS;
+            }
+        }
+        catch(const std::exception& e)
+        {
+            cerr << e.what() << endl;
+            return EXIT_FAILURE;
+        }
+        if(!rows_spec.empty())
+        {
+            auto colon = rows_spec.rfind(':');
+            auto dash = rows_spec.find('-', colon);
+            if(colon == string::npos || dash == string::npos)
+            {
+                cerr << "--rows expects table:start-end" << endl;
+                return EXIT_FAILURE;
+            }
+            string table_name = rows_spec.substr(0, colon);
+            uint_fast64_t start_row = stoull(rows_spec.substr(colon + 1, dash - colon - 1));
+            uint_fast64_t end_row = stoull(rows_spec.substr(dash + 1));
+
+            vector<string> row;
+            try
+            {
+                for(uint_fast64_t k = start_row; k <= end_row; ++k)
+                {
+                    rg_engine.generate_row(table_name, k, row);
+                    for(size_t i = 0; i < row.size(); ++i)
+                        cout << row[i] << (i + 1 < row.size() ? '|' : '\n');
+                }
+            }
+            catch(const std::exception& e)
+            {
+                cerr << e.what() << endl;
+                return EXIT_FAILURE;
+            }
+            return EXIT_SUCCESS;
+        }
+        try
+        {
+            if(!output_spec.empty())
+                rg_engine.set_output(output_spec);
+            if(!writer_mode.empty())
+                rg_engine.set_writer(writer_mode);
+            rg_engine.set_stats(print_stats);
+            //--seeds first..last: every seed of the range, each written to its own directory
+            if(!seeds_spec.empty())
+            {
+                auto dots = seeds_spec.find("..");
+                if(dots == string::npos)
+                    throw runtime_error("--seeds expects first..last");
+                redgene_ensemble rg_ensemble(rg_engine, stoull(seeds_spec.substr(0, dots)),
+                    stoull(seeds_spec.substr(dots + 2)));
+                if(!rg_ensemble.generate(status, resume))
+                    return EXIT_FAILURE;
+            }
+            else
+                rg_engine.generate(resume);
+        }
+        catch(const std::exception& e)
+        {
+            cerr << e.what() << endl;
+            return EXIT_FAILURE;
+        }
+        status << "Data Generated Successfully." << endl;
+    }
+
     return EXIT_SUCCESS;
 }
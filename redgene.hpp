@@ -1,8 +1,15 @@
 #include "rglibinc.hpp"
+#include "rg_arena.hpp"
 #include "rand_engine.hpp"
 #include "prob_dist.hpp"
 #include "rg_utils.hpp"
 #include "json.hpp"
+#include "rg_io.hpp"
+#include "rg_sketch.hpp"
+#include "rg_plan.hpp"
+#ifdef REDGENE_HAVE_SQLITE
+#include "rg_sqlite.hpp"
+#endif
 #include <type_traits>
 
 using json = nlohmann::json;
@@ -11,12 +18,40 @@ namespace redgene
 {
     //reference zipf alpha value: NO = NA, LOW = 0.5, MEDIUM = 0.9, HIGH = 1.1, EXTREME = 1.5
     using skewness = enum skewness { NO, LOW, MEDIUM, HIGH, EXTREME };
-    using redgene_types = enum redgene_types { INT, REAL, STRING, DATE, TIMESTAMP };
+    using redgene_types = enum redgene_types { INT, REAL, STRING, DATE, TIMESTAMP, DECIMAL };
     using constraints = enum cofnstraints { NONE, PK, FK, FK_UNIQUE, COMP_PK, COMP_FK };
+    using dependency_modes = enum dependency_modes { FUNCTIONAL, OFFSET, CONDITIONAL };
+    using arrival_processes = enum arrival_processes { POISSON, BURSTY, DIURNAL };
  
     static const string UNIX_TIME_EPOCH = "1970-JAN-01 05:30:00";
-
-    const float get_alpha_value(const skewness skew)
+    static const string CHECKPOINT_MANIFEST = "redgene_checkpoint.json";
+    //rows generated per batch
+    static const uint_fast64_t BATCH_ROWS = 4096;
+    //batches in flight between the generate, encode and write stages
+    static const size_t PIPELINE_SLOTS = 8;
+    //rows of the largest table in the planner's calibration run
+    static const uint_fast64_t PLAN_CALIBRATION_ROWS = 50000;
+    //most common values and histogram buckets in a computed profile
+    static const size_t PROFILE_MCV_LIMIT = 16;
+    static const size_t PROFILE_HISTOGRAM_BUCKETS = 32;
+    //Bloom filter bits per key when verifying key uniqueness and references
+    static const double VERIFY_BLOOM_BITS = 32;
+    //keys per run of a "clustered_runs" pk_order without a run_length
+    static const uint_fast64_t PK_RUN_LENGTH = 64;
+    //rows sharing a time window in a monotonic TIMESTAMP column
+    static const uint_fast64_t ARRIVAL_BLOCK = 4096;
+    //swing of the diurnal arrival rate around its mean, the peak rate is 1.8 times the mean
+    static const double DIURNAL_AMPLITUDE = 0.8;
+    //largest DECIMAL precision, the unscaled values are 64 bit integers
+    static const uint_fast8_t DECIMAL_MAX_PRECISION = 18;
+    //rows per transaction when loading a "sqlite:" output
+    static const uint_fast64_t SQLITE_COMMIT_ROWS = 1000000;
+    static const uint_fast64_t DECIMAL_POWERS[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+        1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+        1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL,
+        10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL};
+
+    inline const float get_alpha_value(const skewness skew)
     {
         float alpha;
         switch(skew)
@@ -40,33 +75,121 @@ namespace redgene
     }
 
     //REDGENE VALIDATOR CLASS
+    //Checks a schema in two passes over references into its json: the first indexes every
+    //table and its columns by name, the second checks each attribute and resolves references
+    //(FK, COMP_FK, depends_on) through the index. Every problem found is recorded with its
+    //JSON path, see get_errors().
     class redgene_validator
     {
     private:
+        typedef struct column_entry
+        {
+            const json* column_obj;
+            //upper case, empty without a constraint
+            string constraint;
+        } column_entry;
+
+        typedef struct table_entry
+        {
+            const json* table_obj;
+            unordered_map<string, column_entry> columns;
+            //COMP_PK columns in schema order
+            vector<string> comp_pk_columns;
+        } table_entry;
+
         json redgene_json;
         bool valid = false;
-        static const set<string> valid_types;
-        static const set<string> valid_constraints;
-        static const set<string> valid_skewness;
+        vector<string> errors;
+        //scale factor a compiled plan was resolved at, 0 for a schema template
+        double compiled_scale_factor = 0;
+        //index of the tables, by position and by name; it points into redgene_json and
+        //only lives while validate() runs
+        vector<table_entry> table_index;
+        unordered_map<string, size_t> table_positions;
+
+        static const set<string>& valid_types();
+        static const set<string>& valid_constraints();
+        static const set<string>& valid_skewness();
+        static const set<string>& valid_scaling();
+        static const set<string>& valid_dependency_modes();
+        static string to_upper(string value);
+        static void normalize_spellings(json& tab_arr);
+        static bool has_ref_constraint(const json& json_node);
         bool validate();
+        void index_tables(const json& tab_arr);
+        const table_entry* find_table(const string& table_name) const;
+        string string_attribute(const json& json_node, const string& key, const string& path);
+        void add_error(const string& path, const string& message);
+        void validate_table(const table_entry& table, const string& path);
+        void validate_column(const json& column_obj, const string& constraint, const table_entry& table,
+            const string& path,
+            int& comp_pk_is_ref, map<string, set<string>>& comp_fk_refs);
         bool validate_fk_refspec(const string& ref_tab, 
             const string& ref_col, const bool is_composite);
+        void validate_scaling(const json& json_node, const string& path);
+        void validate_dependency(const json& column_obj, const string& type, const table_entry& table,
+            const string& path);
+        void validate_profile(const json& column_obj, const string& type, const string& path);
+        void validate_deltas(const json& deltas);
     public:
         redgene_validator() = delete;
         redgene_validator(const string json_filename);
+        redgene_validator(const char* json_filename);
+        redgene_validator(const json& redgene_json);
         json& get_redgene_valid_json();
         bool is_valid() const;
+        //"<json path>: <problem>" for every problem found, empty when valid
+        const vector<string>& get_errors() const;
+        //whether the schema came from a compiled plan, already validated and resolved
+        bool is_compiled() const;
+        double get_compiled_scale_factor() const;
         bool is_ref_constraint(json& json_node);
+        static bool is_valid_output(const string& output_spec, const size_t table_count);
     };
 
-    const set<string> redgene_validator::valid_types = {"INT", "REAL", "STRING", "DATE", "TIMESTAMP"};
-    const set<string> redgene_validator::valid_constraints = {"PK", "FK", "COMP_PK", "COMP_FK", "FK_UNIQUE"};
-    const set<string> redgene_validator::valid_skewness = {"NO", "LOW", "MEDIUM", "HIGH", "EXTREME"};
+    inline const set<string>& redgene_validator::valid_types()
+    {
+        static const set<string> types = {"INT", "REAL", "STRING", "DATE", "TIMESTAMP", "DECIMAL"};
+        return types;
+    }
+
+    inline const set<string>& redgene_validator::valid_constraints()
+    {
+        static const set<string> constraints = {"PK", "FK", "COMP_PK", "COMP_FK", "FK_UNIQUE"};
+        return constraints;
+    }
+
+    inline const set<string>& redgene_validator::valid_skewness()
+    {
+        static const set<string> skewness = {"NO", "LOW", "MEDIUM", "HIGH", "EXTREME"};
+        return skewness;
+    }
+
+    inline const set<string>& redgene_validator::valid_scaling()
+    {
+        static const set<string> scaling = {"linear", "fixed", "sublinear"};
+        return scaling;
+    }
+
+    inline const set<string>& redgene_validator::valid_dependency_modes()
+    {
+        static const set<string> modes = {"FUNCTIONAL", "OFFSET", "CONDITIONAL"};
+        return modes;
+    }
 
-    redgene_validator::redgene_validator(const string json_filename)
+    inline redgene_validator::redgene_validator(const string json_filename)
     {
         try
         {
+            //a plan was validated when it was compiled
+            if(compiled_plan::is_plan_file(json_filename))
+            {
+                json plan = compiled_plan::load(json_filename);
+                redgene_json = move(plan["schema"]);
+                compiled_scale_factor = plan["scale_factor"].get<double>();
+                valid = true;
+                return;
+            }
             ifstream ifstrm(json_filename);
             ifstrm >> redgene_json;
             valid = validate();
@@ -74,1426 +197,4063 @@ namespace redgene
         catch(json::parse_error& e)
         {
             redgene_json = NULL;
-            // output exception information
-            cout << "message: " << e.what() << '\n'
-                << "exception id: " << e.id << '\n'
-                << "byte position of error: " << e.byte << endl;
+            errors.push_back(json_filename + ": " + e.what());
         }
         catch(const std::exception& e)
         {
             cerr << e.what() << endl;
+            errors.push_back(e.what());
         }  
+        table_index.clear();
+        table_positions.clear();
     }
 
-    bool redgene_validator::is_valid() const
+    inline redgene_validator::redgene_validator(const char* json_filename) :
+        redgene_validator(string(json_filename))
     {
-        return valid;
+
     }
 
-    bool redgene_validator::validate()
+    //schema handed in by a program embedding redgene, instead of a file
+    inline redgene_validator::redgene_validator(const json& redgene_json) :
+        redgene_json(redgene_json)
     {
-        set<string> aux_tab_names_set;
-        auto tab_arr_obj = redgene_json.find("tables");
-        if(tab_arr_obj == redgene_json.end())
-            return false;
-        
-        //Table Names Validation
-        for(auto table_obj : tab_arr_obj.value())
+        try
         {
-            auto table_name = table_obj.find("table_name");
-            if(table_name == table_obj.end())
-                return false;
-            auto table_name_str = table_name.value().get<string>();
-            transform(table_name_str.begin(), table_name_str.end(),
-                table_name_str.begin(), ::tolower);
-            aux_tab_names_set.insert(table_name_str);
-
-            //Row Count Validation
-            auto row_count = table_obj.find("row_count");
-            if(row_count == table_obj.end())
-                return false;
-
-            if(!row_count.value().is_number_unsigned())
-                return false;
-
-            //Column Names Validation
-            set<string> aux_col_names_set;
-            auto column_arr_obj = table_obj.find("columns");
-            if(column_arr_obj == table_obj.end())
-                return false;
-            
-            //bool to check all COMP_PKs are of same profile.
-            bool is_comp_pk_a_ref, is_first_occurance = true;
-            //map to track all mapping from columns of COMP_FK table to COMP_PK table columns.
-            map<string, bool> comp_pk_col_vector;
-            for(auto column_obj : column_arr_obj.value())
-            {
-                auto column_name = column_obj.find("column_name");
-                if(column_name == column_obj.end())
-                    return false;
-                auto col_name_str = column_name.value().get<string>();
-                transform(col_name_str.begin(), col_name_str.end(),
-                    col_name_str.begin(), ::tolower);
-                aux_col_names_set.insert(col_name_str);
-
-                auto col_data_type = column_obj.find("type");
-                bool ref_constraint = is_ref_constraint(column_obj);
-
-                //it's invalid to provide both type and reference constraint
-                if(col_data_type != column_obj.end() && ref_constraint)
-                    return false;
-
-                if(col_data_type == column_obj.end() && !ref_constraint)
-                    return false;
-                
-                if(!ref_constraint)
-                {
-                    auto col_data_type_str = col_data_type.value().get<string>();
-                    transform(col_data_type_str.begin(), col_data_type_str.end(),
-                        col_data_type_str.begin(), ::toupper);
-                    
-                    if(valid_types.find(col_data_type_str) == valid_types.end())
-                        return false;
-                } 
-
-                //Check for 'CONSTRAINT', 'CARDINALITY' and 'TYPE'
-                auto cardinality = column_obj.find("cardinality");
-                if(cardinality != column_obj.end())
-                {
-                    if(cardinality.value().get<float>() <= 0.0)
-                        return false;
-                }
+            valid = validate();
+        }
+        catch(const std::exception& e)
+        {
+            cerr << e.what() << endl;
+            errors.push_back(e.what());
+        }
+        table_index.clear();
+        table_positions.clear();
+    }
 
-                auto constraint = column_obj.find("constraint");
-                //Logic to check if invalid constraint value is provided.
-                if(constraint != column_obj.end())
-                {
-                    auto constraint_val = constraint.value().get<string>();
-                    transform(constraint_val.begin(), constraint_val.end(),
-                        constraint_val.begin(), ::toupper);
-                    
-                    if(valid_constraints.find(constraint_val) == valid_constraints.end())
-                        return false;
-                    
-                    //Logic to check dual nature of COMP_PK column (is either independent or has reference column)
-                    if(constraint_val == "COMP_PK")
-                    {
-                        if(is_first_occurance)
-                        {
-                            is_comp_pk_a_ref = ref_constraint;
-                            is_first_occurance = false;
-                        }
-                        else
-                        {
-                            if(is_comp_pk_a_ref != ref_constraint)
-                                return false;
-                        }
-                    }
+    inline bool redgene_validator::is_valid() const
+    {
+        return valid;
+    }
 
-                    if(constraint_val == "PK" || (constraint_val == "COMP_PK" && !ref_constraint))
-                    {
-                        //PK constraint column_type should be INT or STRING only.
-                        auto col_data_type_str = col_data_type.value().get<string>();
-                        transform(col_data_type_str.begin(), col_data_type_str.end(),
-                            col_data_type_str.begin(), ::toupper);
-                        if(!(col_data_type_str == "INT" || col_data_type_str == "STRING"))
-                            return false;
-                    }
-                    //check whether references are provided for ref constraints
-                    //FOREIGN KEY (FK, FK_UNIQUE and COMP_FK)
-                    else if(constraint_val == "FK" || constraint_val == "FK_UNIQUE" || 
-                        (constraint_val == "COMP_PK" && ref_constraint) || 
-                        constraint_val == "COMP_FK")
-                    {
-                        auto ref_table = column_obj.find("ref_tab");
-                        auto ref_column = column_obj.find("ref_col");
+    inline const vector<string>& redgene_validator::get_errors() const
+    {
+        return errors;
+    }
 
-                        if((ref_table == column_obj.end()) || (ref_column == column_obj.end()))
-                            return false;
-                        
-                        if(!validate_fk_refspec(ref_table.value().get<string>(),
-                            ref_column.value().get<string>(), 
-                            (constraint_val == "COMP_FK")))
-                            return false;
-                        
-                        if(constraint_val == "COMP_FK")
-                        {
-                            //check if comp_pk map is not created yet and create one.
-                            //itrerate on comp_pk table and add all comp_pk columns to map.
-                            if(comp_pk_col_vector.size() == 0)
-                            {
-                                for(auto indv_table_obj : tab_arr_obj.value())
-                                {
-                                    if(indv_table_obj.find("table_name").value().get<string>() == 
-                                        ref_table.value().get<string>())
-                                    {
-                                        for(auto indv_column_obj : indv_table_obj.find("columns").value())
-                                        {
-                                            if(indv_column_obj.find("constraint") != indv_column_obj.end())
-                                                if(indv_column_obj.find("constraint").value() == "COMP_PK")
-                                                    comp_pk_col_vector.insert(pair<string, bool>
-                                                    (indv_column_obj.find("column_name").value().get<string>(), false));
-                                        }
-                                    }
-                                }
-                            }
-                            comp_pk_col_vector.find(ref_column.value().get<string>())->second = true;
-                        }
-                    }
-                }
-                
-                auto skewness = column_obj.find("skewness");
-                //Logic to check if invalid skewness value is provided
-                if(skewness != column_obj.end())
-                {
-                    auto skewness_val = skewness.value().get<string>();
-                    transform(skewness_val.begin(), skewness_val.end(),
-                        skewness_val.begin(), ::toupper);
+    inline bool redgene_validator::is_compiled() const
+    {
+        return compiled_scale_factor > 0;
+    }
 
-                    if(valid_skewness.find(skewness_val) == valid_skewness.end())
-                        return false;
-                }
-                
-                if(col_data_type != column_obj.end())
-                {
-                    auto type = col_data_type.value().get<string>();
-                    transform(type.begin(), type.end(), type.begin(), ::toupper);
+    inline double redgene_validator::get_compiled_scale_factor() const
+    {
+        return compiled_scale_factor;
+    }
 
-                    if(valid_types.find(type) == valid_types.end())
-                        return false;
+    //stdout carries a single table, a path shared by several tables must contain %t; a
+    //sqlite database holds every table
+    inline bool redgene_validator::is_valid_output(const string& output_spec, const size_t table_count)
+    {
+        if(output_spec.empty() || output_spec == "fifo:" || output_spec == "sqlite:")
+            return false;
+        if(output_spec.compare(0, 7, "sqlite:") == 0)
+            return true;
+        if(output_spec == "-")
+            return table_count == 1;
+        return table_count == 1 || output_spec.find("%t") != string::npos;
+    }
 
-                    if(type == "STRING")
-                    {
-                        auto str_length = column_obj.find("length");
-                        if(str_length != column_obj.end())
-                            if(str_length.value().get<int_fast16_t>() <= 0 
-                                || str_length.value().get<int_fast16_t>() > 4000)
-                                return false;
-                    }
+    inline string redgene_validator::to_upper(string value)
+    {
+        transform(value.begin(), value.end(), value.begin(), ::toupper);
+        return value;
+    }
 
-                    if(type == "REAL")
-                    {
-                        if(constraint != column_obj.end() || cardinality != column_obj.end())
-                            return false;
-                        float real_min = 0.0, real_max = 1.0;
-                        auto real_min_obj = column_obj.find("real_min");
-                        auto real_max_obj = column_obj.find("real_max");
-
-                        if(real_min_obj != column_obj.end())
-                            real_min = real_min_obj.value().get<float>();
-                            
-                        if(real_max_obj != column_obj.end())
-                            real_max = real_max_obj.value().get<float>();
-                        
-                        if(real_min >= real_max)
-                            return false;
-                    }
-                    else if(type == "DATE" || type == "TIMESTAMP")
-                    {
-                        if(constraint != column_obj.end() || cardinality != column_obj.end())
-                            return false;
-                    }
-                    else
-                    {
-                        if(!(constraint != column_obj.end() || cardinality != column_obj.end()))
-                            return false;
-                    }
-                }
-                else
+    //type, constraint and skewness are accepted in any case; they are written back upper
+    //case, the spelling the engine, planner and verifier compare against
+    inline void redgene_validator::normalize_spellings(json& tab_arr)
+    {
+        for(auto& table_obj : tab_arr)
+        {
+            if(!table_obj.is_object() || table_obj.find("columns") == table_obj.end() ||
+                !table_obj.find("columns").value().is_array())
+                continue;
+            for(auto& column_obj : table_obj.find("columns").value())
+            {
+                if(!column_obj.is_object())
+                    continue;
+                for(auto key : {"type", "constraint", "skewness"})
                 {
-                    if(!(constraint != column_obj.end() || cardinality != column_obj.end()))
-                        return false;
+                    auto attribute = column_obj.find(key);
+                    if(attribute != column_obj.end() && attribute.value().is_string())
+                        attribute.value() = to_upper(attribute.value().get<string>());
                 }
             }
-
-            //see if all mapping of columns from COMP_FK to COMP_PK are present.
-            if(comp_pk_col_vector.size() > 0)
-                for(map<string, bool>::const_iterator citr = comp_pk_col_vector.cbegin();
-                    citr != comp_pk_col_vector.cend(); ++citr)
-                       if(!citr->second) return false;
-
-            if(aux_col_names_set.size() != column_arr_obj.value().size())
-                return false;
         }
-
-        if(aux_tab_names_set.size() != tab_arr_obj.value().size())
-            return false;
-
-        return true;
     }
 
-    json& redgene_validator::get_redgene_valid_json()
+    inline void redgene_validator::add_error(const string& path, const string& message)
     {
-        return redgene_json;
+        errors.push_back(path + ": " + message);
     }
 
-    bool redgene_validator::is_ref_constraint(json& json_node)
+    //value of a string attribute, empty when it is missing or not a string
+    inline string redgene_validator::string_attribute(const json& json_node, const string& key,
+        const string& path)
     {
-        bool ref_constraint = false;
-        if(json_node.find("constraint") != json_node.end())
+        auto attribute = json_node.find(key);
+        if(attribute == json_node.end())
+            return "";
+        if(!attribute.value().is_string())
         {
-            auto constraint = json_node.find("constraint").value().get<string>();
-            transform(constraint.begin(), constraint.end(), constraint.begin(), ::toupper);
+            add_error(path + "/" + key, "must be a string");
+            return "";
+        }
+        return attribute.value().get<string>();
+    }
 
-            if(constraint == "FK" || constraint == "FK_UNIQUE" || constraint == "COMP_FK")
-                ref_constraint = true;
-            else if(constraint == "COMP_PK")
-            {
-                ref_constraint = (json_node.find("ref_tab") != json_node.end()) && 
-                    (json_node.find("ref_col") != json_node.end());
-            }
+    inline bool redgene_validator::validate()
+    {
+        errors.clear();
+        auto tab_arr_obj = redgene_json.find("tables");
+        if(tab_arr_obj == redgene_json.end() || !tab_arr_obj.value().is_array())
+        {
+            add_error("/tables", "missing, expected an array of tables");
+            return false;
         }
-        return ref_constraint;
+
+        //Checkpoint interval in rows, 0 disables checkpointing
+        auto checkpoint_rows = redgene_json.find("checkpoint_rows");
+        if(checkpoint_rows != redgene_json.end() && !checkpoint_rows.value().is_number_unsigned())
+            add_error("/checkpoint_rows", "must be an unsigned integer");
+
+        //Scale factor applied to the row counts
+        auto scale_factor = redgene_json.find("scale_factor");
+        if(scale_factor != redgene_json.end() && 
+            (!scale_factor.value().is_number() || scale_factor.value().get<double>() <= 0))
+            add_error("/scale_factor", "must be a number greater than 0");
+
+        //Memory budget the planner warns about, in MB
+        auto memory_budget = redgene_json.find("memory_budget_mb");
+        if(memory_budget != redgene_json.end() && 
+            (!memory_budget.value().is_number() || memory_budget.value().get<double>() <= 0))
+            add_error("/memory_budget_mb", "must be a number greater than 0");
+
+        //Writer backend for files
+        auto writer = redgene_json.find("writer");
+        if(writer != redgene_json.end() && (!writer.value().is_string() || 
+            (writer.value().get<string>() != "buffered" && writer.value().get<string>() != "direct")))
+            add_error("/writer", "must be \"buffered\" or \"direct\"");
+
+        //Output target: "-" (stdout), "fifo:<path>", "sqlite:<path>" or a file path, %t is the
+        //table name
+        auto output = redgene_json.find("output");
+        if(output != redgene_json.end() && (!output.value().is_string() || 
+            !is_valid_output(output.value().get<string>(), tab_arr_obj.value().size())))
+            add_error("/output", "must be \"-\" for a single table, \"fifo:<path>\", \"sqlite:<path>\" "
+                "or a path, with %t when several tables share it");
+
+        //Encoding of the rows written to files, pipes and stdout
+        auto format = redgene_json.find("format");
+        if(format != redgene_json.end() && (!format.value().is_string() || 
+            (format.value().get<string>() != "csv" && format.value().get<string>() != "pgcopy")))
+            add_error("/format", "must be \"csv\" or \"pgcopy\"");
+
+        //When the keys of a "sqlite:" output are indexed
+        auto sqlite_indexes = redgene_json.find("sqlite_indexes");
+        if(sqlite_indexes != redgene_json.end() && (!sqlite_indexes.value().is_string() || 
+            (sqlite_indexes.value().get<string>() != "inline" && 
+            sqlite_indexes.value().get<string>() != "after_load")))
+            add_error("/sqlite_indexes", "must be \"inline\" or \"after_load\"");
+
+        normalize_spellings(tab_arr_obj.value());
+        index_tables(tab_arr_obj.value());
+        for(size_t t = 0; t < table_index.size(); ++t)
+            validate_table(table_index[t], "/tables/" + to_string(t));
+
+        auto deltas = redgene_json.find("deltas");
+        if(deltas != redgene_json.end())
+            validate_deltas(deltas.value());
+        return errors.empty();
     }
 
-    bool redgene_validator::validate_fk_refspec(const string& ref_tab,
-        const string& ref_col, const bool is_composite)
+    //first pass: tables and columns by name, names unique regardless of case
+    inline void redgene_validator::index_tables(const json& tab_arr)
     {
-        bool fk_ref_valid = false;
-        //probe for ref_tab
-        auto table_array = redgene_json.find("tables");
-        for(auto table : table_array.value())
+        table_index.clear();
+        table_positions.clear();
+        set<string> aux_tab_names_set;
+        for(size_t t = 0; t < tab_arr.size(); ++t)
         {
-            if(table.find("table_name").value().get<string>() == ref_tab)
+            const json& table_obj = tab_arr[t];
+            string path = "/tables/" + to_string(t);
+            table_index.push_back(table_entry());
+            table_entry& table = table_index.back();
+            table.table_obj = &table_obj;
+            if(!table_obj.is_object())
+            {
+                add_error(path, "must be an object");
+                continue;
+            }
+
+            //Table Names Validation
+            string table_name = string_attribute(table_obj, "table_name", path);
+            if(table_obj.find("table_name") == table_obj.end())
+                add_error(path, "missing table_name");
+            else if(!table_name.empty())
             {
-                for(auto column : table.find("columns").value())
+                string table_name_lower = table_name;
+                transform(table_name_lower.begin(), table_name_lower.end(), 
+                    table_name_lower.begin(), ::tolower);
+                if(!aux_tab_names_set.insert(table_name_lower).second)
+                    add_error(path + "/table_name", "duplicate table name " + table_name);
+                else
+                    table_positions.emplace(table_name, t);
+            }
+
+            //Column Names Validation
+            auto column_arr_obj = table_obj.find("columns");
+            if(column_arr_obj == table_obj.end() || !column_arr_obj.value().is_array())
+                continue;
+            set<string> aux_col_names_set;
+            for(size_t c = 0; c < column_arr_obj.value().size(); ++c)
+            {
+                const json& column_obj = column_arr_obj.value()[c];
+                string col_path = path + "/columns/" + to_string(c);
+                if(!column_obj.is_object())
+                    continue;
+                string column_name = string_attribute(column_obj, "column_name", col_path);
+                if(column_obj.find("column_name") == column_obj.end())
+                    add_error(col_path, "missing column_name");
+                if(column_name.empty())
+                    continue;
+
+                string column_name_lower = column_name;
+                transform(column_name_lower.begin(), column_name_lower.end(),
+                    column_name_lower.begin(), ::tolower);
+                if(!aux_col_names_set.insert(column_name_lower).second)
                 {
-                    if(column.find("column_name").value().get<string>() == ref_col)
-                    {
-                        auto constraint = column.find("constraint");
-                        if(constraint != column.end())
-                        {
-                            if(constraint.value().get<string>() == "PK" && !is_composite)
-                                fk_ref_valid = true;
-                            else if(constraint.value().get<string>() == "COMP_PK" && is_composite)
-                                fk_ref_valid = true;
-                        }
-                    }
+                    add_error(col_path + "/column_name", "duplicate column name " + column_name);
+                    continue;
                 }
+                column_entry column = {&column_obj, to_upper(string_attribute(column_obj, "constraint", col_path))};
+                table.columns.emplace(column_name, column);
+                if(column.constraint == "COMP_PK")
+                    table.comp_pk_columns.push_back(column_name);
             }
         }
-        return fk_ref_valid;
     }
 
+    inline const redgene_validator::table_entry* redgene_validator::find_table(const string& table_name) const
+    {
+        auto position = table_positions.find(table_name);
+        return (position == table_positions.end()) ? nullptr : &table_index[position->second];
+    }
 
-    class column;
-
-    //TABLE ATTRIBUTES SECTION
-    class table
+    inline void redgene_validator::validate_table(const table_entry& table, const string& path)
     {
-    private:
-        const string table_name;
-        mutable uint_fast64_t row_count;
-        unordered_map<string, column*> col_map;
-        vector<string> insert_order;
-    public:
-        table(const string& table_name, const uint_fast64_t row_count)
-            : table_name(table_name), row_count(row_count)
-        {
+        const json& table_obj = *table.table_obj;
+        if(!table_obj.is_object())
+            return;
+
+        //Row Count Validation
+        auto row_count = table_obj.find("row_count");
+        if(row_count == table_obj.end())
+            add_error(path, "missing row_count");
+        else if(!row_count.value().is_number_unsigned())
+            add_error(path + "/row_count", "must be an unsigned integer");
+
+        validate_scaling(table_obj, path);
 
+        auto column_arr_obj = table_obj.find("columns");
+        if(column_arr_obj == table_obj.end() || !column_arr_obj.value().is_array())
+        {
+            add_error(path, "missing columns, expected an array of columns");
+            return;
         }
 
-        void insert_column_metadata_obj(string& column_name, column* col_metadata)
+        //whether the COMP_PK columns reference another table, all of them alike (-1 before the first)
+        int comp_pk_is_ref = -1;
+        //COMP_PK columns referenced by the COMP_FK columns, by referenced table
+        map<string, set<string>> comp_fk_refs;
+        for(size_t c = 0; c < column_arr_obj.value().size(); ++c)
         {
-            col_map.insert(pair<string, column*>(column_name, col_metadata));
-            insert_order.push_back(column_name);
+            string col_path = path + "/columns/" + to_string(c);
+            const json& column_obj = column_arr_obj.value()[c];
+            if(!column_obj.is_object())
+            {
+                add_error(col_path, "must be an object");
+                continue;
+            }
+            //the constraint index_tables parsed, columns it left out (without a name or
+            //duplicates) have theirs parsed here
+            const column_entry* entry = nullptr;
+            auto column_name = column_obj.find("column_name");
+            if(column_name != column_obj.end() && column_name.value().is_string())
+            {
+                auto indexed = table.columns.find(column_name.value().get<string>());
+                if(indexed != table.columns.end() && indexed->second.column_obj == &column_obj)
+                    entry = &indexed->second;
+            }
+            string constraint = entry ? entry->constraint :
+                to_upper(string_attribute(column_obj, "constraint", col_path));
+            validate_column(column_obj, constraint, table, col_path, comp_pk_is_ref, comp_fk_refs);
         }
 
-        unordered_map<string, column*>& get_column_map()
+        //see if all mapping of columns from COMP_FK to COMP_PK are present.
+        for(auto& comp_fk_ref : comp_fk_refs)
         {
-            return col_map;
+            const table_entry* ref_table = find_table(comp_fk_ref.first);
+            if(ref_table == nullptr)
+                continue;
+            for(auto& comp_pk_column : ref_table->comp_pk_columns)
+                if(comp_fk_ref.second.find(comp_pk_column) == comp_fk_ref.second.end())
+                    add_error(path + "/columns", "no COMP_FK column references " + 
+                        comp_fk_ref.first + "." + comp_pk_column);
         }
+    }
 
-        vector<string> get_column_order()
+    inline void redgene_validator::validate_column(const json& column_obj, const string& constraint,
+        const table_entry& table, const string& path, int& comp_pk_is_ref, map<string, set<string>>& comp_fk_refs)
+    {
+        auto col_data_type = column_obj.find("type");
+        bool ref_constraint = has_ref_constraint(column_obj);
+
+        //it's invalid to provide both type and reference constraint
+        if(col_data_type != column_obj.end() && ref_constraint)
+            add_error(path + "/type", "not allowed with a referencing constraint, the type comes from ref_col");
+        if(col_data_type == column_obj.end() && !ref_constraint)
+            add_error(path, "missing type");
+        
+        string type = to_upper(string_attribute(column_obj, "type", path));
+        bool unknown_type = !type.empty() && valid_types().find(type) == valid_types().end();
+        if(unknown_type)
+            add_error(path + "/type", "unknown type " + type);
+
+        //Check for 'CONSTRAINT', 'CARDINALITY' and 'TYPE'
+        auto cardinality = column_obj.find("cardinality");
+        if(cardinality != column_obj.end() && 
+            (!cardinality.value().is_number() || cardinality.value().get<float>() <= 0.0))
+            add_error(path + "/cardinality", "must be a number greater than 0");
+        validate_scaling(column_obj, path);
+        validate_dependency(column_obj, type, table, path);
+        validate_profile(column_obj, type, path);
+        //OFFSET dependents take their values from the parent and profiled columns from
+        //their profile, not from a cardinality
+        auto depends_on = column_obj.find("depends_on");
+        bool has_value_source = column_obj.find("profile") != column_obj.end() ||
+            (depends_on != column_obj.end() && depends_on.value().is_object() &&
+            depends_on.value().find("mode") != depends_on.value().end() &&
+            depends_on.value().find("mode").value() == "OFFSET");
+
+        //Share of nulls, keys never hold nulls
+        auto null_ratio = column_obj.find("null_ratio");
+        if(null_ratio != column_obj.end())
         {
-            return insert_order;
+            if(!null_ratio.value().is_number() || null_ratio.value().get<double>() < 0 ||
+                null_ratio.value().get<double>() > 1)
+                add_error(path + "/null_ratio", "must be a number in [0, 1]");
+            if(constraint == "PK" || constraint == "COMP_PK")
+                add_error(path + "/null_ratio", "not allowed on a " + constraint + " column");
         }
 
-        string get_table_name() const
+        //Order of the keys of a PK column
+        string pk_order = string_attribute(column_obj, "pk_order", path);
+        if(column_obj.find("pk_order") != column_obj.end())
         {
-            return table_name;
+            if(pk_order != "sequential" && pk_order != "random" && pk_order != "clustered_runs")
+                add_error(path + "/pk_order", "must be \"sequential\", \"random\" or \"clustered_runs\"");
+            if(constraint != "PK")
+                add_error(path + "/pk_order", "only allowed on a PK column");
+        }
+        auto run_length = column_obj.find("run_length");
+        if(run_length != column_obj.end())
+        {
+            if(pk_order != "clustered_runs")
+                add_error(path + "/run_length", "only allowed with the clustered_runs pk_order");
+            if(!run_length.value().is_number_unsigned() || run_length.value().get<uint_fast64_t>() == 0)
+                add_error(path + "/run_length", "must be an unsigned integer greater than 0");
         }
 
-        uint_fast64_t get_row_count() const
+        //Order of the parent keys in a FK_UNIQUE column
+        string fk_order = string_attribute(column_obj, "fk_order", path);
+        if(column_obj.find("fk_order") != column_obj.end())
         {
-            return row_count;
+            if(fk_order != "sequential" && fk_order != "random")
+                add_error(path + "/fk_order", "must be \"sequential\" or \"random\"");
+            if(constraint != "FK_UNIQUE")
+                add_error(path + "/fk_order", "only allowed on a FK_UNIQUE column");
         }
 
-        void set_row_count(uint_fast64_t row_count)
+        //Time ordered TIMESTAMP columns and their arrival process
+        string order = string_attribute(column_obj, "order", path);
+        if(column_obj.find("order") != column_obj.end())
         {
-            this->row_count = row_count;
+            if(order != "random" && order != "monotonic")
+                add_error(path + "/order", "must be \"random\" or \"monotonic\"");
+            if(type != "TIMESTAMP")
+                add_error(path + "/order", "only allowed on a TIMESTAMP column");
+            else if(order == "monotonic" && (depends_on != column_obj.end() || 
+                column_obj.find("profile") != column_obj.end()))
+                add_error(path + "/order", "not allowed on a dependent or profiled column");
+        }
+        string arrivals = string_attribute(column_obj, "arrivals", path);
+        if(column_obj.find("arrivals") != column_obj.end())
+        {
+            if(arrivals != "poisson" && arrivals != "bursty" && arrivals != "diurnal")
+                add_error(path + "/arrivals", "must be \"poisson\", \"bursty\" or \"diurnal\"");
+            if(order != "monotonic")
+                add_error(path + "/arrivals", "only allowed with the monotonic order");
+        }
+        auto peak_hour = column_obj.find("peak_hour");
+        if(peak_hour != column_obj.end())
+        {
+            if(!peak_hour.value().is_number() || peak_hour.value().get<double>() < 0 ||
+                peak_hour.value().get<double>() >= 24)
+                add_error(path + "/peak_hour", "must be a number in [0, 24)");
+            if(arrivals != "diurnal")
+                add_error(path + "/peak_hour", "only allowed with the diurnal arrivals");
         }
-    };
 
-    //COLUMN ATTRIBUTES SECTION
-    class column
-    {
-    protected:
-        const string col_name;
-        mutable redgene_types data_type;
-        const constraints constraint;
-    public:
-        column(const string& col_name, const redgene_types data_type,
-            const constraints constraint) : 
-            col_name(col_name), data_type(data_type), constraint(constraint)
+        //Logic to check if invalid constraint value is provided.
+        if(column_obj.find("constraint") != column_obj.end() && !constraint.empty())
         {
+            if(valid_constraints().find(constraint) == valid_constraints().end())
+                add_error(path + "/constraint", "unknown constraint " + constraint);
+            
+            //Logic to check dual nature of COMP_PK column (is either independent or has reference column)
+            if(constraint == "COMP_PK")
+            {
+                if(comp_pk_is_ref == -1)
+                    comp_pk_is_ref = ref_constraint;
+                else if(comp_pk_is_ref != ref_constraint)
+                    add_error(path, "COMP_PK columns must all reference other tables or none of them");
+            }
 
+            if(constraint == "PK" || (constraint == "COMP_PK" && !ref_constraint))
+            {
+                //PK constraint column_type should be INT or STRING only.
+                if(!type.empty() && type != "INT" && type != "STRING")
+                    add_error(path + "/type", constraint + " columns must be INT or STRING");
+            }
+            //check whether references are provided for ref constraints
+            //FOREIGN KEY (FK, FK_UNIQUE and COMP_FK)
+            else if(constraint == "FK" || constraint == "FK_UNIQUE" || 
+                (constraint == "COMP_PK" && ref_constraint) || constraint == "COMP_FK")
+            {
+                string ref_table = string_attribute(column_obj, "ref_tab", path);
+                string ref_column = string_attribute(column_obj, "ref_col", path);
+                if(column_obj.find("ref_tab") == column_obj.end() || column_obj.find("ref_col") == column_obj.end())
+                    add_error(path, constraint + " columns need ref_tab and ref_col");
+                else if(!ref_table.empty() && !ref_column.empty())
+                {
+                    bool is_composite = (constraint == "COMP_FK");
+                    if(!validate_fk_refspec(ref_table, ref_column, is_composite))
+                        add_error(path + "/ref_col", ref_table + "." + ref_column + " is not a " + 
+                            (is_composite ? "COMP_PK" : "PK") + " column");
+                    else if(is_composite)
+                        comp_fk_refs[ref_table].insert(ref_column);
+                }
+            }
         }
-        string column_name() const
+        
+        //Logic to check if invalid skewness value is provided
+        string skewness = to_upper(string_attribute(column_obj, "skewness", path));
+        if(!skewness.empty() && valid_skewness().find(skewness) == valid_skewness().end())
+            add_error(path + "/skewness", "unknown skewness " + skewness);
+        
+        bool has_constraint = column_obj.find("constraint") != column_obj.end();
+        bool has_cardinality = cardinality != column_obj.end();
+        if(type == "STRING")
         {
-            return col_name;
+            auto str_length = column_obj.find("length");
+            if(str_length != column_obj.end() && (!str_length.value().is_number_integer() ||
+                str_length.value().get<int_fast64_t>() <= 0 || str_length.value().get<int_fast64_t>() > 4000))
+                add_error(path + "/length", "must be an integer in [1, 4000]");
         }
 
-        redgene_types get_type() const
+        if(type == "REAL")
         {
-            return data_type;
+            if(has_constraint || has_cardinality)
+                add_error(path, "REAL columns take no constraint or cardinality");
+            float real_min = 0.0, real_max = 1.0;
+            auto real_min_obj = column_obj.find("real_min");
+            auto real_max_obj = column_obj.find("real_max");
+
+            if(real_min_obj != column_obj.end() && real_min_obj.value().is_number())
+                real_min = real_min_obj.value().get<float>();
+            if(real_max_obj != column_obj.end() && real_max_obj.value().is_number())
+                real_max = real_max_obj.value().get<float>();
+            
+            if(real_min >= real_max)
+                add_error(path, "real_min must be less than real_max");
         }
 
-        constraints get_constraint_type() const
+        else if(type == "DECIMAL")
         {
-            return constraint;
+            if(has_constraint)
+                add_error(path, "DECIMAL columns take no constraint");
+            uint_fast64_t precision = DECIMAL_MAX_PRECISION, scale = 2;
+            auto precision_obj = column_obj.find("precision");
+            auto scale_obj = column_obj.find("scale");
+            if(precision_obj != column_obj.end())
+            {
+                if(!precision_obj.value().is_number_unsigned() || precision_obj.value().get<uint_fast64_t>() == 0 ||
+                    precision_obj.value().get<uint_fast64_t>() > DECIMAL_MAX_PRECISION)
+                    add_error(path + "/precision", "must be an integer in [1, 18]");
+                else
+                    precision = precision_obj.value().get<uint_fast64_t>();
+            }
+            if(scale_obj != column_obj.end())
+            {
+                if(!scale_obj.value().is_number_unsigned() || scale_obj.value().get<uint_fast64_t>() > precision)
+                    add_error(path + "/scale", "must be an integer in [0, precision]");
+                else
+                    scale = scale_obj.value().get<uint_fast64_t>();
+            }
+            else
+                scale = min(scale, precision);
+
+            double real_min = 0.0, real_max = 1.0;
+            auto real_min_obj = column_obj.find("real_min");
+            auto real_max_obj = column_obj.find("real_max");
+            if(real_min_obj != column_obj.end() && real_min_obj.value().is_number())
+                real_min = real_min_obj.value().get<double>();
+            if(real_max_obj != column_obj.end() && real_max_obj.value().is_number())
+                real_max = real_max_obj.value().get<double>();
+            if(real_min >= real_max)
+                add_error(path, "real_min must be less than real_max");
+            //every value has at most precision digits
+            double limit = DECIMAL_POWERS[precision] / static_cast<double>(DECIMAL_POWERS[scale]);
+            if(fabs(real_min) >= limit || fabs(real_max) >= limit)
+                add_error(path, "real_min and real_max must fit DECIMAL(" + to_string(precision) + "," +
+                    to_string(scale) + ")");
         }
-
-        void set_data_type(redgene_types data_type)
+        else if(type == "DATE" || type == "TIMESTAMP")
         {
-            this->data_type = data_type;
+            if(has_constraint || has_cardinality)
+                add_error(path, type + " columns take no constraint or cardinality");
         }
+        else if(!unknown_type && !(has_constraint || has_cardinality || (!type.empty() && has_value_source)))
+            add_error(path, "needs a constraint or a cardinality");
+    }
 
-        virtual ~column() = default;
-    };
-
-    //SECTION-1: NORMAL COLUMN GENERATION CLASSES
-    class normal_int_column : public column
+    //"scaling" of a table or of an absolute cardinality, with the exponent of sublinear
+    inline void redgene_validator::validate_scaling(const json& json_node, const string& path)
     {
-    private:
-        prng_engine<uint_fast64_t>& prng;
-        const table& _table;
-        float cardinality;
-        const skewness skew;
-
-        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+        auto scaling = json_node.find("scaling");
+        if(scaling != json_node.end() && (!scaling.value().is_string() || 
+            valid_scaling().find(scaling.value().get<string>()) == valid_scaling().end()))
+            add_error(path + "/scaling", "must be \"linear\", \"fixed\" or \"sublinear\"");
+
+        auto scale_exponent = json_node.find("scale_exponent");
+        if(scale_exponent != json_node.end() && (!scale_exponent.value().is_number() || 
+            scale_exponent.value().get<double>() <= 0))
+            add_error(path + "/scale_exponent", "must be a number greater than 0");
+    }
 
-        //Members to support cardinality specification between 0 and 1
-        prob_dist_base<uint_fast64_t>* support_pdf_lt1card = nullptr;
-        uint_fast64_t call_index = 0;
+    //"depends_on" of a column derived from another column of the same table
+    inline void redgene_validator::validate_dependency(const json& column_obj, const string& type,
+        const table_entry& table, const string& path)
+    {
+        auto depends_on = column_obj.find("depends_on");
+        if(depends_on == column_obj.end())
+            return;
+        string dep_path = path + "/depends_on";
+        if(!depends_on.value().is_object())
+        {
+            add_error(dep_path, "must be an object");
+            return;
+        }
+        if(column_obj.find("constraint") != column_obj.end())
+            add_error(dep_path, "not allowed on a column with a constraint");
+
+        string parent_name = string_attribute(depends_on.value(), "column", dep_path);
+        string mode = string_attribute(depends_on.value(), "mode", dep_path);
+        if(valid_dependency_modes().find(mode) == valid_dependency_modes().end())
+            add_error(dep_path + "/mode", "must be FUNCTIONAL, OFFSET or CONDITIONAL");
+
+        //the parent is a generated column of the same table
+        auto parent = table.columns.find(parent_name);
+        const json* parent_obj = (parent == table.columns.end()) ? nullptr : parent->second.column_obj;
+        if(parent_name.empty())
+            add_error(dep_path, "missing column");
+        else if(parent_obj == nullptr)
+            add_error(dep_path + "/column", "no column " + parent_name + " in the table");
+        else if(parent_obj == &column_obj)
+            add_error(dep_path + "/column", "a column cannot depend on itself");
+        else if(parent_obj->find("depends_on") != parent_obj->end())
+            add_error(dep_path + "/column", parent_name + " is itself derived");
+
+        if(mode == "OFFSET")
+        {
+            if(type != "INT" && type != "DATE" && type != "TIMESTAMP")
+                add_error(path + "/type", "OFFSET columns must be INT, DATE or TIMESTAMP");
+            auto min_offset = depends_on.value().find("min_offset");
+            auto max_offset = depends_on.value().find("max_offset");
+            if(min_offset == depends_on.value().end() || max_offset == depends_on.value().end() ||
+                !min_offset.value().is_number_integer() || !max_offset.value().is_number_integer())
+                add_error(dep_path, "OFFSET needs integer min_offset and max_offset");
+            else
+            {
+                if(min_offset.value().get<int_fast64_t>() > max_offset.value().get<int_fast64_t>())
+                    add_error(dep_path, "min_offset must not be greater than max_offset");
+                //INT values are unsigned
+                if(type == "INT" && min_offset.value().get<int_fast64_t>() < 0)
+                    add_error(dep_path + "/min_offset", "must not be negative for INT columns");
+            }
 
-        void set_pdf_context()
+            //the offset is added to a parent of the same type
+            if(parent_obj != nullptr && parent_obj->find("type") != parent_obj->end() &&
+                parent_obj->find("type").value().is_string() &&
+                to_upper(parent_obj->find("type").value().get<string>()) != type)
+                add_error(dep_path + "/column", "OFFSET needs a parent of the same type");
+        }
+        else if(!mode.empty())
         {
-            if(cardinality == 1)
-                pdfuncbase = new simple_incrementer<uint_fast64_t>();
-            else if(cardinality < 1)
-            {   
-                call_index = _table.get_row_count()*cardinality;
-                support_pdf_lt1card = new simple_incrementer<uint_fast64_t>();
+            if(type != "INT" && type != "STRING")
+                add_error(path + "/type", mode + " columns must be INT or STRING");
+            auto spread = depends_on.value().find("spread");
+            if(spread != depends_on.value().end() && (!spread.value().is_number_unsigned() ||
+                spread.value().get<uint_fast64_t>() == 0))
+                add_error(dep_path + "/spread", "must be an unsigned integer greater than 0");
+        }
+    }
 
-                if(skew == skewness::NO)
-                    pdfuncbase = new uniform_int_dist_engine<uint_fast64_t, uint_fast64_t>(prng, 1,
-                        (_table.get_row_count()*cardinality));
-                else
-                    pdfuncbase = new zipf_distribution<uint_fast64_t, uint_fast64_t>(prng,
-                        _table.get_row_count()*cardinality, get_alpha_value(skew));
-            }
-            else if(cardinality > 1)
-            {
-                if(skew == skewness::NO)
-                    pdfuncbase = new uniform_int_dist_engine<uint_fast64_t, uint_fast64_t>(prng, 1,
-                        cardinality);
-                else
-                    pdfuncbase = new zipf_distribution<uint_fast64_t, uint_fast64_t>(prng,
-                        cardinality, get_alpha_value(skew));
-            }
+    //"profile" of a column generated to match real data
+    inline void redgene_validator::validate_profile(const json& column_obj, const string& type,
+        const string& path)
+    {
+        auto profile = column_obj.find("profile");
+        if(profile == column_obj.end())
+            return;
+        string prof_path = path + "/profile";
+        if(!profile.value().is_object())
+        {
+            add_error(prof_path, "must be an object");
+            return;
         }
+        if(column_obj.find("constraint") != column_obj.end() || column_obj.find("depends_on") != column_obj.end() ||
+            column_obj.find("cardinality") != column_obj.end())
+            add_error(prof_path, "not allowed with a constraint, depends_on or cardinality");
 
-    public:
-        normal_int_column(prng_engine<uint_fast64_t>& prng, const table& table, 
-            const string& col_name, const float cardinality, const skewness skew = skewness::NO) : 
-            column(col_name, redgene_types::INT, constraints::NONE), prng(prng), _table(table), 
-            cardinality(cardinality), skew(skew)
+        if(type != "INT" && type != "REAL" && type != "STRING")
         {
-            set_pdf_context();
+            add_error(path + "/type", "profiled columns must be INT, REAL or STRING");
+            return;
         }
 
-        ~normal_int_column()
+        //most common values, their frequencies sum up to at most 1
+        double mcv_total = 0;
+        size_t mcv_count = 0;
+        auto mcv = profile.value().find("mcv");
+        if(mcv != profile.value().end())
         {
-            delete pdfuncbase;
-            if(support_pdf_lt1card)
-                delete support_pdf_lt1card;
+            if(!mcv.value().is_array())
+                add_error(prof_path + "/mcv", "must be an array");
+            else
+                for(size_t i = 0; i < mcv.value().size(); ++i)
+                {
+                    const json& mcv_obj = mcv.value()[i];
+                    string mcv_path = prof_path + "/mcv/" + to_string(i);
+                    auto value = mcv_obj.find("value");
+                    auto freq = mcv_obj.find("freq");
+                    if(value == mcv_obj.end() || freq == mcv_obj.end() || !freq.value().is_number() ||
+                        freq.value().get<double>() <= 0 || freq.value().get<double>() > 1)
+                    {
+                        add_error(mcv_path, "needs a value and a freq in (0, 1]");
+                        continue;
+                    }
+                    if((type == "INT" && !value.value().is_number_unsigned()) ||
+                        (type == "REAL" && !value.value().is_number()) ||
+                        (type == "STRING" && !value.value().is_string()))
+                        add_error(mcv_path + "/value", "must be a " + type + " value");
+                    mcv_total += freq.value().get<double>();
+                    ++mcv_count;
+                }
+            if(mcv_total > 1 + 1e-6)
+                add_error(prof_path + "/mcv", "frequencies sum up to more than 1");
         }
 
-        virtual uint_fast64_t yield()
+        auto ndv = profile.value().find("ndv");
+        bool valid_ndv = ndv != profile.value().end() && ndv.value().is_number_unsigned();
+        if(ndv != profile.value().end() && (!valid_ndv || ndv.value().get<uint_fast64_t>() < mcv_count))
+            add_error(prof_path + "/ndv", "must be an unsigned integer, at least the number of mcvs");
+
+        //bucket bounds of the equi-depth histogram, non decreasing
+        auto histogram = profile.value().find("histogram");
+        if(histogram != profile.value().end())
         {
-            uint_fast64_t ret_val;
-            if(cardinality < 1)
+            if(type == "STRING")
+                add_error(prof_path + "/histogram", "not allowed on STRING columns");
+            else if(!histogram.value().is_array() || histogram.value().size() < 2)
+                add_error(prof_path + "/histogram", "must be an array of at least 2 bounds");
+            else
             {
-                if(call_index > 0)
+                double last = -numeric_limits<double>::max();
+                for(auto& bound : histogram.value())
                 {
-                    ret_val = (*support_pdf_lt1card)();
-                    --call_index;
+                    if(!bound.is_number() || bound.get<double>() < last || 
+                        (type == "INT" && bound.get<double>() < 0))
+                    {
+                        add_error(prof_path + "/histogram", "bounds must be non decreasing numbers" +
+                            string(type == "INT" ? ", not negative" : ""));
+                        break;
+                    }
+                    last = bound.get<double>();
                 }
-                else
-                    ret_val = (*pdfuncbase)();
             }
-            else
-                ret_val = (*pdfuncbase)();
+        }
 
-            return ret_val;
+        //the share the mcvs leave needs somewhere to go
+        if(mcv_total < 1 - 1e-6)
+        {
+            if(type == "STRING" && (!valid_ndv || ndv.value().get<uint_fast64_t>() <= mcv_count))
+                add_error(prof_path, "STRING profiles need an ndv above the number of mcvs "
+                    "when the mcv frequencies sum up to less than 1");
+            if(type != "STRING" && histogram == profile.value().end())
+                add_error(prof_path, "needs a histogram when the mcv frequencies sum up to less than 1");
         }
-    };
+    }
 
-    class normal_real_column : public column
+    //"deltas": change events per table after the base load. Inserts need keys that can
+    //continue past the base rows, updates and deletes a key to find their row, and a table
+    //other tables reference keeps all its rows, so their references stay valid.
+    inline void redgene_validator::validate_deltas(const json& deltas)
     {
-    private:
-        prng_engine<uint_fast64_t>& prng;
-        const table& _table;
-        float real_min;
-        float real_max;
-        prob_dist_base<double>* pdfuncbase = nullptr;
-    public:
-        normal_real_column(prng_engine<uint_fast64_t>& prng, const table& table, const string& col_name,
-            const float real_min = 0.0, const float real_max = 1.0) : column(col_name, redgene_types::REAL,
-            constraints::NONE), prng(prng), _table(table), real_min(real_min), real_max(real_max)
+        if(!deltas.is_array())
         {
-            pdfuncbase = new uniform_real_dist_engine<uint_fast64_t, double>(prng, 
-                real_min, real_max);
+            add_error("/deltas", "must be an array");
+            return;
         }
+        set<string> referenced_tables, delta_tables;
+        for(auto& table : table_index)
+            for(auto& column : table.columns)
+            {
+                auto ref_tab = column.second.column_obj->find("ref_tab");
+                if(ref_tab != column.second.column_obj->end() && ref_tab.value().is_string())
+                    referenced_tables.insert(ref_tab.value().get<string>());
+            }
 
-        ~normal_real_column()
+        for(size_t d = 0; d < deltas.size(); ++d)
         {
-            delete pdfuncbase;
+            const json& delta_obj = deltas[d];
+            string path = "/deltas/" + to_string(d);
+            if(!delta_obj.is_object())
+            {
+                add_error(path, "must be an object");
+                continue;
+            }
+            string table_name = string_attribute(delta_obj, "table", path);
+            const table_entry* table = find_table(table_name);
+            if(table == nullptr)
+                add_error(path + "/table", "no table " + table_name + " in the schema");
+            else if(!delta_tables.insert(table_name).second)
+                add_error(path + "/table", "more than one delta stream for " + table_name);
+
+            auto events = delta_obj.find("events");
+            if(events == delta_obj.end() || !events.value().is_number_unsigned() || 
+                events.value().get<uint_fast64_t>() == 0)
+                add_error(path + "/events", "must be an unsigned integer greater than 0");
+
+            //shares of the ops, summing up to 1
+            auto mix = delta_obj.find("mix");
+            if(mix == delta_obj.end() || !mix.value().is_object())
+            {
+                add_error(path + "/mix", "must be an object of insert, update and delete shares");
+                continue;
+            }
+            double total = 0;
+            for(auto share = mix.value().begin(); share != mix.value().end(); ++share)
+            {
+                if(share.key() != "insert" && share.key() != "update" && share.key() != "delete")
+                    add_error(path + "/mix/" + share.key(), "unknown op, expected insert, update or delete");
+                else if(!share.value().is_number() || share.value().get<double>() < 0)
+                    add_error(path + "/mix/" + share.key(), "must be a number not below 0");
+                else
+                    total += share.value().get<double>();
+            }
+            if(abs(total - 1) > 1e-6)
+                add_error(path + "/mix", "shares must sum up to 1");
+            if(table == nullptr)
+                continue;
+
+            auto share_of = [&](const string& op)
+            {
+                auto share = mix.value().find(op);
+                return (share != mix.value().end() && share.value().is_number()) ? share.value().get<double>() : 0.0;
+            };
+            bool has_key = false;
+            string unused_key_constraint;
+            for(auto& column : table->columns)
+            {
+                if(column.second.constraint == "PK" || column.second.constraint == "COMP_PK")
+                    has_key = true;
+                if(column.second.constraint == "COMP_PK" || column.second.constraint == "FK_UNIQUE")
+                    unused_key_constraint = column.second.constraint;
+            }
+            if(share_of("insert") > 0 && !unused_key_constraint.empty())
+                add_error(path + "/mix/insert", "not allowed on a table with " + unused_key_constraint +
+                    " columns, new rows would need unused keys");
+            if((share_of("update") > 0 || share_of("delete") > 0) && !has_key)
+                add_error(path + "/mix", "updates and deletes need a table with a PK or COMP_PK");
+            if(share_of("delete") > 0 && referenced_tables.count(table_name))
+                add_error(path + "/mix/delete", "not allowed on a table other tables reference");
         }
+    }
 
-        inline double yield()
+    inline json& redgene_validator::get_redgene_valid_json()
+    {
+        return redgene_json;
+    }
+
+    inline bool redgene_validator::has_ref_constraint(const json& json_node)
+    {
+        bool ref_constraint = false;
+        auto constraint_obj = json_node.find("constraint");
+        if(constraint_obj != json_node.end() && constraint_obj.value().is_string())
         {
-            return (*pdfuncbase)();
+            auto constraint = to_upper(constraint_obj.value().get<string>());
+            if(constraint == "FK" || constraint == "FK_UNIQUE" || constraint == "COMP_FK")
+                ref_constraint = true;
+            else if(constraint == "COMP_PK")
+            {
+                ref_constraint = (json_node.find("ref_tab") != json_node.end()) && 
+                    (json_node.find("ref_col") != json_node.end());
+            }
         }
+        return ref_constraint;
+    }
 
-    };
+    inline bool redgene_validator::is_ref_constraint(json& json_node)
+    {
+        return has_ref_constraint(json_node);
+    }
 
-    class normal_date_column : public column
+    //ref_tab.ref_col is a PK column, or a COMP_PK column for a composite reference
+    inline bool redgene_validator::validate_fk_refspec(const string& ref_tab,
+        const string& ref_col, const bool is_composite)
+    {
+        const table_entry* table = find_table(ref_tab);
+        if(table == nullptr)
+            return false;
+        auto column = table->columns.find(ref_col);
+        if(column == table->columns.end())
+            return false;
+        return column->second.constraint == (is_composite ? "COMP_PK" : "PK");
+    }
+
+    class column;
+
+    //TABLE ATTRIBUTES SECTION
+    class table
     {
     private:
-        prng_engine<uint_fast64_t>& prng;
-        const table& _table;
-        const string user_date;
-        uint_fast8_t range_in_years;
-        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+        const string table_name;
+        mutable uint_fast64_t row_count;
+        unordered_map<string, column*> col_map;
+        vector<string> insert_order;
+        //generation state of the columns, deleted columns leave their memory here until
+        //the table itself goes
+        arena state_arena;
+    public:
+        table(const string& table_name, const uint_fast64_t row_count)
+            : table_name(table_name), row_count(row_count)
+        {
 
-        chrono::system_clock::time_point ref_timepoint;
-        chrono::system_clock::time_point adv_timepoint;
-        const uint64_t sec_a_year = 31536000;
-        chrono::seconds interval_in_second;
+        }
 
-        //objects to map user-defined date time reference
-        time_t rawtime, time_tobj;
-        struct tm *tm_map, *ltm;
-        string* date_string = nullptr;
-        string* mon_str = nullptr;
+        void insert_column_metadata_obj(string& column_name, column* col_metadata)
+        {
+            col_map.insert(pair<string, column*>(column_name, col_metadata));
+            insert_order.push_back(column_name);
+        }
 
-        const string& get_month(int mon_no)
+        unordered_map<string, column*>& get_column_map()
         {
-            switch(mon_no)
-            {
-                case 0: *mon_str = "JAN"; break;
-                case 1: *mon_str = "FEB"; break;
-                case 2: *mon_str = "MAR"; break;
-                case 3: *mon_str = "APR"; break;
-                case 4: *mon_str = "MAY"; break;
-                case 5: *mon_str = "JUN"; break;
-                case 6: *mon_str = "JUL"; break;
-                case 7: *mon_str = "AUG"; break;
-                case 8: *mon_str = "SEP"; break;
-                case 9: *mon_str = "OCT"; break;
-                case 10: *mon_str = "NOV"; break;
-                case 11: *mon_str = "DEC"; break;
-            }
-            return *mon_str;
+            return col_map;
         }
 
-    public:
-        normal_date_column(prng_engine<uint_fast64_t>& p_prng, 
-            const table& p_table, const string& p_col_name, 
-            const string p_user_date = redgene::UNIX_TIME_EPOCH, 
-            const uint_fast8_t p_range_in_years = 10) :
-            column(p_col_name, redgene_types::DATE, constraints::NONE),
-            prng(p_prng), _table(p_table), user_date(p_user_date), 
-            range_in_years(p_range_in_years)
+        vector<string> get_column_order()
         {
-            if(user_date != redgene::UNIX_TIME_EPOCH)
-            {
-                time(&rawtime);
-                tm_map = localtime(&rawtime);
-                istringstream user_date_str(user_date);
-                user_date_str >> get_time(tm_map, "%Y-%b-%d");
-                rawtime =  mktime(tm_map);
+            return insert_order;
+        }
 
-                ref_timepoint = chrono::system_clock::from_time_t(rawtime);
-            }
-            adv_timepoint = ref_timepoint + 
-                chrono::seconds(sec_a_year*range_in_years);
+        vector<column*> get_ordered_columns()
+        {
+            vector<column*> columns;
+            for(auto& column_name : insert_order)
+                columns.push_back(col_map[column_name]);
+            return columns;
+        }
 
-            interval_in_second = chrono::duration_cast<chrono::seconds>
-                (adv_timepoint - ref_timepoint);
-            
-            pdfuncbase = new uniform_int_dist_engine<>(prng, 
-                0, interval_in_second.count());
-            date_string = new string(11, ' ');
-            mon_str = new string(3, ' ');
+        string get_table_name() const
+        {
+            return table_name;
         }
 
-        const string& yield()
+        uint_fast64_t get_row_count() const
         {
-            time_tobj = std::chrono::system_clock::to_time_t(
-                ref_timepoint + chrono::seconds((*pdfuncbase)()));
-            ltm = localtime(&time_tobj);            
-            
-            stringstream ss;
-            ss << setfill('0') << setw(2) << ltm->tm_mday 
-                << "-" << get_month(ltm->tm_mon)
-                << "-" << 1900+ltm->tm_year;
+            return row_count;
+        }
 
-            *date_string = ss.str();
-            return *date_string;
+        void set_row_count(uint_fast64_t row_count)
+        {
+            this->row_count = row_count;
         }
 
-        ~normal_date_column()
+        arena& get_arena()
         {
-            if(pdfuncbase)
-                delete pdfuncbase;
-            if(date_string)
-                delete date_string;
-            if(mon_str)
-                delete mon_str;
+            return state_arena;
         }
     };
 
-    class normal_timestamp_column : public column
+    //BATCH SECTION
+    //non owning view of a string value held by a column_vector
+    typedef struct str_view
+    {
+        const char* data;
+        size_t size;
+
+        string to_string() const
+        {
+            return string(data, size);
+        }
+    } str_view;
+
+    //typed values of one column for a batch of rows. STRING values are packed back to back
+    //into a single character buffer, DATE and TIMESTAMP values are seconds since the epoch and
+    //DECIMAL values are unscaled integers, value * 10^scale, as Parquet and Arrow store them.
+    class column_vector
     {
     private:
-        prng_engine<uint_fast64_t>& prng;
-        const table& _table;
-        const string user_date;
-        uint_fast8_t range_in_years;
-        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+        redgene_types type;
+        vector<uint_fast64_t> int_values;
+        vector<double> real_values;
+        vector<int_fast64_t> time_values;
+        vector<int_fast64_t> decimal_values;
+        uint_fast8_t precision = DECIMAL_MAX_PRECISION;
+        uint_fast8_t scale = 0;
+        vector<char> str_buffer;
+        vector<uint_fast64_t> str_offsets;
+        //Arrow style validity bitmap, bit i set when value i is not null; empty without nulls
+        vector<uint_fast64_t> validity;
+    public:
+        column_vector(const redgene_types type = redgene_types::INT) : type(type), str_offsets(1, 0)
+        {
 
-        chrono::system_clock::time_point ref_timepoint;
-        chrono::system_clock::time_point adv_timepoint;
-        const uint64_t sec_a_year = 31536000;
-        chrono::seconds interval_in_second;
+        }
 
-        //objects to map user-defined date time reference
-        time_t rawtime, time_tobj;
-        struct tm *tm_map, *ltm;
-        string* date_string = nullptr;
-        string* mon_str = nullptr;
+        redgene_types get_type() const
+        {
+            return type;
+        }
 
-        const string& get_month(int mon_no)
+        uint_fast64_t size() const
         {
-            switch(mon_no)
+            switch(type)
             {
-                case 0: *mon_str = "JAN"; break;
-                case 1: *mon_str = "FEB"; break;
-                case 2: *mon_str = "MAR"; break;
-                case 3: *mon_str = "APR"; break;
-                case 4: *mon_str = "MAY"; break;
-                case 5: *mon_str = "JUN"; break;
-                case 6: *mon_str = "JUL"; break;
-                case 7: *mon_str = "AUG"; break;
-                case 8: *mon_str = "SEP"; break;
-                case 9: *mon_str = "OCT"; break;
-                case 10: *mon_str = "NOV"; break;
-                case 11: *mon_str = "DEC"; break;
+                case redgene_types::INT: return int_values.size();
+                case redgene_types::REAL: return real_values.size();
+                case redgene_types::STRING: return str_offsets.size() - 1;
+                case redgene_types::DECIMAL: return decimal_values.size();
+                default: return time_values.size();
             }
-            return *mon_str;
         }
 
-    public:
-        normal_timestamp_column(prng_engine<uint_fast64_t>& p_prng, 
-            const table& p_table, const string& p_col_name, 
-            const string p_user_date = redgene::UNIX_TIME_EPOCH, 
-            const uint_fast8_t p_range_in_years = 10) :
-            column(p_col_name, redgene_types::TIMESTAMP, constraints::NONE),
-            prng(p_prng), _table(p_table), user_date(p_user_date), 
-            range_in_years(p_range_in_years)
+        void clear()
         {
-            if(user_date != redgene::UNIX_TIME_EPOCH)
-            {
-                time(&rawtime);
-                tm_map = localtime(&rawtime);
-                istringstream user_date_str(user_date);
-                user_date_str >> get_time(tm_map, "%Y-%b-%d %H:%M:%S");
-                rawtime =  mktime(tm_map);
+            int_values.clear();
+            real_values.clear();
+            time_values.clear();
+            decimal_values.clear();
+            str_buffer.clear();
+            str_offsets.resize(1);
+            validity.clear();
+        }
 
-                ref_timepoint = chrono::system_clock::from_time_t(rawtime);
-            }
-            adv_timepoint = ref_timepoint + 
-                chrono::seconds(sec_a_year*range_in_years);
+        //nulls the values of rows [first_row, first_row + rows) whose bit is drawn; null
+        //values are still generated, so the column's streams do not depend on the nulls
+        void set_nulls(const bulk_bernoulli& null_bits, const uint_fast64_t first_row, 
+            const uint_fast64_t rows)
+        {
+            null_bits.fill(validity, first_row, rows);
+            for(auto& word : validity)
+                word = ~word;
+            if(rows & 63)
+                validity.back() &= (1ULL << (rows & 63)) - 1;
+        }
 
-            interval_in_second = chrono::duration_cast<chrono::seconds>
-                (adv_timepoint - ref_timepoint);
-            
-            pdfuncbase = new uniform_int_dist_engine<>(prng, 
-                0, interval_in_second.count());
-            date_string = new string(25, ' ');
-            mon_str = new string(3, ' ');
+        inline bool is_null(const uint_fast64_t idx) const
+        {
+            return !validity.empty() && !((validity[idx >> 6] >> (idx & 63)) & 1);
         }
 
-        const string& yield()
+        const vector<uint_fast64_t>& get_validity() const
         {
-            time_tobj = std::chrono::system_clock::to_time_t(
-                ref_timepoint + chrono::seconds((*pdfuncbase)()));
-            ltm = localtime(&time_tobj);            
-            
-            stringstream ss;
-            ss << setfill('0') << setw(2) << ltm->tm_mday 
-                << "-" << get_month(ltm->tm_mon)
-                << "-" << 1900+ltm->tm_year << " "
-                << setw(2) << ltm->tm_hour << ":"
-                << setw(2) << ltm->tm_min << ":"
-                << setw(2) << ltm->tm_sec;
-
-            *date_string = ss.str();
-            return *date_string;
+            return validity;
         }
 
-        ~normal_timestamp_column()
+        inline void append_int(const uint_fast64_t value)
         {
-            if(pdfuncbase)
-                delete pdfuncbase;
-            if(date_string)
-                delete date_string;
-            if(mon_str)
-                delete mon_str;
+            int_values.push_back(value);
         }
-    };
-    
-    class normal_string_column : public column
-    {
-    private:
-        prng_engine<uint_fast64_t>& prng;
-        const table& _table;
-        float cardinality;
-        uint_fast16_t str_length;
-        bool is_var_length;
-        const skewness skew;
-        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
-        rand_str_generator<>* rand_str_gen = nullptr;
 
-        //Members to support cardinality specification between 0 and 1
-        prob_dist_base<uint_fast64_t>* support_pdf_lt1card = nullptr;
-        uint_fast64_t call_index = 0;
+        //room for the next rows INT values, written in place by a generation kernel
+        uint_fast64_t* extend_ints(const uint_fast64_t rows)
+        {
+            int_values.resize(int_values.size() + rows);
+            return int_values.data() + int_values.size() - rows;
+        }
 
-        void set_pdf_context()
+        inline void append_real(const double value)
         {
-            if(cardinality == 1)
-                pdfuncbase = new simple_incrementer<>();
-            else if(cardinality < 1)
-            {
-                call_index = _table.get_row_count()*cardinality;
-                support_pdf_lt1card = new simple_incrementer<uint_fast64_t>();
+            real_values.push_back(value);
+        }
 
-                if(skew == skewness::NO)
-                    pdfuncbase = new uniform_int_dist_engine<>(prng, 1, 
-                        (_table.get_row_count()*cardinality));
-                else
-                    pdfuncbase = new zipf_distribution<>(prng,
-                        _table.get_row_count()*cardinality, get_alpha_value(skew));
-            }
-            else if(cardinality > 1)
-            {
-                if(skew == skewness::NO)
-                    pdfuncbase = new uniform_int_dist_engine<>(prng, 1,
-                        cardinality);
-                else
-                    pdfuncbase = new zipf_distribution<>(prng,
-                        cardinality, get_alpha_value(skew));
-            }
+        inline void append_time(const int_fast64_t value)
+        {
+            time_values.push_back(value);
+        }
 
-            if(cardinality >= 0.7 && cardinality <= 1.0)
-            {
-                bool bypass_warehouse_check = !(is_var_length && skew != skewness::NO);
-                rand_str_gen = new rand_str_generator<>(str_length, is_var_length, 
-                    bypass_warehouse_check);
-            }
-            else if((cardinality > 0 && cardinality < 0.7) || cardinality > 1)
-                rand_str_gen = new rand_str_generator<>(str_length, is_var_length, false);
+        inline void append_decimal(const int_fast64_t value)
+        {
+            decimal_values.push_back(value);
         }
-    public:
-        normal_string_column(prng_engine<uint_fast64_t>& prng, const table& table, const string& col_name,
-            const float cardinality, const skewness skew = skewness::NO, const uint_fast16_t str_length = 10, 
-            const bool var_length = false) : column(col_name, redgene_types::STRING, constraints::NONE),
-            prng(prng), _table(table), cardinality(cardinality), skew(skew), str_length(str_length), 
-            is_var_length(var_length)
+
+        void set_decimal(const uint_fast8_t precision, const uint_fast8_t scale)
         {
-            set_pdf_context();
+            this->precision = precision;
+            this->scale = scale;
         }
 
-        ~normal_string_column()
+        inline void append_str(const string& value)
         {
-            if(rand_str_gen)
-                delete rand_str_gen;
-            if(pdfuncbase)
-                delete pdfuncbase;
-            if(support_pdf_lt1card)
-                delete support_pdf_lt1card;
+            str_buffer.insert(str_buffer.end(), value.begin(), value.end());
+            str_offsets.push_back(str_buffer.size());
         }
 
-        virtual const string& yield()
+        //appends value idx of a vector of the same type, without its null bit
+        void append_from(const column_vector& values, const uint_fast64_t idx)
         {
-            uint_fast64_t key_val;
-            if(cardinality < 1)
+            switch(type)
             {
-                if(call_index > 0)
+                case redgene_types::INT:
+                    int_values.push_back(values.int_values[idx]);
+                    break;
+                case redgene_types::REAL:
+                    real_values.push_back(values.real_values[idx]);
+                    break;
+                case redgene_types::STRING:
                 {
-                    key_val = (*support_pdf_lt1card)();
-                    --call_index;
+                    str_view view = values.get_str(idx);
+                    str_buffer.insert(str_buffer.end(), view.data, view.data + view.size);
+                    str_offsets.push_back(str_buffer.size());
+                    break;
                 }
-                else
-                    key_val = (*pdfuncbase)();
+                case redgene_types::DECIMAL:
+                    decimal_values.push_back(values.decimal_values[idx]);
+                    break;
+                default:
+                    time_values.push_back(values.time_values[idx]);
             }
-            else
-                key_val = (*pdfuncbase)();
-            return (*rand_str_gen)(key_val);
         }
 
-        uint_fast16_t get_str_length() const
+        const vector<uint_fast64_t>& get_ints() const
         {
-            return str_length;
+            return int_values;
         }
 
-        bool get_is_var_length() const
+        const vector<double>& get_reals() const
         {
-            return is_var_length;
+            return real_values;
         }
-    };
 
-    class pk_int_column : public normal_int_column
-    {
-    public:
-        pk_int_column(prng_engine<uint_fast64_t>& prng, const table& table,
-            const string& col_name) : normal_int_column(prng, table, col_name, 1)
+        const vector<int_fast64_t>& get_times() const
         {
-
+            return time_values;
         }
-        
-        ~pk_int_column() = default;
 
-        virtual inline uint_fast64_t yield()
+        const vector<int_fast64_t>& get_decimals() const
         {
-            return this->normal_int_column::yield();
+            return decimal_values;
         }
-    };
 
-    class pk_string_column : public normal_string_column
-    {
-    public:
-        pk_string_column(prng_engine<uint_fast64_t>& prng, const table& table,
-            const string& col_name, const uint_fast16_t str_length = 10, 
-            const bool var_length = false) : normal_string_column(prng, table, col_name, 
-            1, skewness::NO, str_length, var_length)
+        uint_fast8_t get_precision() const
         {
-
+            return precision;
         }
 
-        ~pk_string_column() = default;
+        uint_fast8_t get_scale() const
+        {
+            return scale;
+        }
 
-        virtual const string& yield()
+        //view into the batch's buffer, valid until the batch is refilled
+        str_view get_str(const uint_fast64_t idx) const
         {
-            return normal_string_column::yield();
+            str_view view = {str_buffer.data() + str_offsets[idx], 
+                static_cast<size_t>(str_offsets[idx + 1] - str_offsets[idx])};
+            return view;
         }
     };
-    
-    class fk_int_column : public normal_int_column
+
+    //consecutive rows of one table, stored column by column
+    class row_batch
     {
     private:
-        float fk_cardinality;
+        vector<string> column_names;
+        vector<column_vector> columns;
+        uint_fast64_t first_row = 0;
+        uint_fast64_t rows = 0;
     public:
-        fk_int_column(prng_engine<uint_fast64_t>& prng, const table& table,
-            const string& col_name, const float cardinality, const skewness skew = skewness::NO)
-            : normal_int_column(prng, table, col_name, cardinality, skew), fk_cardinality(cardinality)
+        void add_column(const string& column_name, const redgene_types type)
         {
-
+            column_names.push_back(column_name);
+            columns.push_back(column_vector(type));
         }
 
-        ~fk_int_column() = default;
-
-        virtual inline uint_fast64_t yield()
+        void reset(const uint_fast64_t first_row)
         {
-            return normal_int_column::yield();
+            for(auto& col_vector : columns)
+                col_vector.clear();
+            this->first_row = first_row;
+            rows = 0;
         }
-    };
 
-    class fk_string_column : public normal_string_column
-    {
-    private:
-        float cardinality;
-        uint_fast16_t str_length;
-        bool var_length;
-    public:
-        fk_string_column(prng_engine<uint_fast64_t>& prng, const table& table,
-            const string& col_name, const float cardinality, const uint_fast16_t str_length, 
-            const bool var_length, const skewness skew = skewness::NO) :
-            normal_string_column(prng, table, col_name, cardinality, skew, str_length, var_length)
+        size_t column_count() const
         {
-
+            return columns.size();
         }
 
-        ~fk_string_column() = default;
-
-        virtual const string& yield()
+        const string& column_name(const size_t idx) const
         {
-            return normal_string_column::yield();
+            return column_names[idx];
         }
-    };
 
-    class fk_unique_int_column : public normal_int_column
-    {
-    public:
-        fk_unique_int_column(prng_engine<uint_fast64_t>& prng, const table& table, 
-            const string& col_name) :
-            normal_int_column(prng, table, col_name, 1)
+        const column_vector& column(const size_t idx) const
         {
-
+            return columns[idx];
         }
 
-        ~fk_unique_int_column() = default;
-
-        inline uint_fast64_t yield()
+        column_vector& column(const size_t idx)
         {
-            return normal_int_column::yield();
+            return columns[idx];
         }
-    };
 
-    class fk_unique_string_column : public normal_string_column
-    {
-    public:
-        fk_unique_string_column(prng_engine<uint_fast64_t>& prng, const table& table,
-            const string& col_name, const uint_fast16_t str_length, const bool var_length) :
-            normal_string_column(prng, table, col_name, 1, skewness::NO, str_length, var_length)
+        uint_fast64_t get_first_row() const
         {
-
+            return first_row;
         }
 
-        ~fk_unique_string_column() = default;
+        uint_fast64_t size() const
+        {
+            return rows;
+        }
 
-        const string& yield()
+        void set_size(const uint_fast64_t rows)
         {
-            return normal_string_column::yield();
+            this->rows = rows;
         }
     };
 
-    //int composite primary key class
-    class comp_pk_int_column : public column
-    {
-    private:
-        prng_engine<uint_fast64_t>& prng;
-        const table& _table;
-        
-        const uint_fast64_t amount;
-        const uint_fast64_t max;
-        const uint_fast64_t repeat_window;
-        const uint_fast64_t group_size;
+    static const char* const MONTH_NAMES[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+        "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
 
-        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
-    public:
-        comp_pk_int_column(prng_engine<uint_fast64_t>& prng, const table& _table, const string& col_name,
-            const uint_fast64_t prng_seed, const uint_fast64_t amount, const uint_fast64_t max, 
-            const uint_fast64_t repeat_window, const uint_fast64_t group_size) :
-            prng(prng), _table(_table), column(col_name, redgene_types::INT, constraints::COMP_PK), 
-            amount(amount), max(max), repeat_window(repeat_window), group_size(group_size)
+    inline void append_digits(string& out, uint_fast64_t value, const uint_fast8_t min_width = 1)
+    {
+        char buf[20];
+        uint_fast8_t pos = sizeof(buf);
+        do
         {
-            //reset prng to seed value provided.
-            //so that we can have all columns invovled in the comp_pk generation 
-            //be having same random vector to generate the combination of comp_pk values 
-            prng.seed(prng_seed);
-            pdfuncbase = new set_distribution<uint_fast64_t>(prng, amount, max);
-        }
+            buf[--pos] = '0' + value % 10;
+            value /= 10;
+        } while(value || (sizeof(buf) - pos) < min_width);
+        out.append(buf + pos, sizeof(buf) - pos);
+    }
 
-        ~comp_pk_int_column()
+    //fixed point text of an unscaled DECIMAL value, with integer arithmetic only
+    inline void append_decimal_string(string& out, const int_fast64_t value, const uint_fast8_t scale)
+    {
+        uint_fast64_t magnitude = static_cast<uint_fast64_t>(value);
+        if(value < 0)
         {
-            if(pdfuncbase)
-                delete pdfuncbase;
+            out += '-';
+            magnitude = ~magnitude + 1;
         }
-
-        uint_fast64_t get_distinct_count() const
+        append_digits(out, magnitude / DECIMAL_POWERS[scale]);
+        if(scale)
         {
-            return amount;
+            out += '.';
+            append_digits(out, magnitude % DECIMAL_POWERS[scale], scale);
         }
+    }
 
-        uint_fast64_t get_maxvalue() const
+    //DD-MON-YYYY[ HH:MM:SS] in local time, as written for DATE and TIMESTAMP columns
+    inline void append_date_string(string& out, const time_t time_val, const bool with_time)
+    {
+        struct tm ltm;
+        localtime_r(&time_val, &ltm);
+        append_digits(out, ltm.tm_mday, 2);
+        out += '-';
+        out += MONTH_NAMES[ltm.tm_mon];
+        out += '-';
+        append_digits(out, 1900 + ltm.tm_year);
+        if(with_time)
         {
-            return max;
+            out += ' ';
+            append_digits(out, ltm.tm_hour, 2);
+            out += ':';
+            append_digits(out, ltm.tm_min, 2);
+            out += ':';
+            append_digits(out, ltm.tm_sec, 2);
         }
+    }
 
-        uint_fast64_t get_repeat_window() const
+    //YYYY-MM-DD[ HH:MM:SS] in local time, the form SQLite's date functions read
+    inline void append_iso_date_string(string& out, const time_t time_val, const bool with_time)
+    {
+        struct tm ltm;
+        localtime_r(&time_val, &ltm);
+        append_digits(out, 1900 + ltm.tm_year, 4);
+        out += '-';
+        append_digits(out, ltm.tm_mon + 1, 2);
+        out += '-';
+        append_digits(out, ltm.tm_mday, 2);
+        if(with_time)
         {
-            return repeat_window;
+            out += ' ';
+            append_digits(out, ltm.tm_hour, 2);
+            out += ':';
+            append_digits(out, ltm.tm_min, 2);
+            out += ':';
+            append_digits(out, ltm.tm_sec, 2);
         }
+    }
 
-        uint_fast64_t get_group_size() const
+    //text form of one value, identical to what ostream formatting wrote before batches;
+    //nulls are empty
+    inline void append_value_text(string& out, const column_vector& values, const uint_fast64_t idx)
+    {
+        if(values.is_null(idx))
+            return;
+        switch(values.get_type())
         {
-            return group_size;
+            case redgene_types::INT:
+                append_digits(out, values.get_ints()[idx]);
+                break;
+            case redgene_types::REAL:
+            {
+                char buf[32];
+                int len = snprintf(buf, sizeof(buf), "%g", values.get_reals()[idx]);
+                out.append(buf, len);
+                break;
+            }
+            case redgene_types::STRING:
+            {
+                str_view view = values.get_str(idx);
+                out.append(view.data, view.size);
+                break;
+            }
+            case redgene_types::DATE:
+                append_date_string(out, values.get_times()[idx], false);
+                break;
+            case redgene_types::TIMESTAMP:
+                append_date_string(out, values.get_times()[idx], true);
+                break;
+            case redgene_types::DECIMAL:
+                append_decimal_string(out, values.get_decimals()[idx], values.get_scale());
+                break;
         }
+    }
 
-        inline uint_fast64_t yield()
+    //'|' delimited, newline terminated rows of the batch
+    inline void append_csv_rows(string& out, const row_batch& batch)
+    {
+        for(uint_fast64_t row = 0; row < batch.size(); ++row)
         {
-            uint_fast64_t tmp = (*pdfuncbase)();
-            tmp %= repeat_window;
-            if(tmp == 0)
-                tmp = repeat_window;
-            return ceil((double)tmp / group_size);
+            for(size_t col = 0; col < batch.column_count(); ++col)
+            {
+                if(col)
+                    out += '|';
+                append_value_text(out, batch.column(col), row);
+            }
+            out += '\n';
         }
-    };
+    }
 
-    class comp_pk_string_column : public comp_pk_int_column
+    //PostgreSQL binary COPY ("format": "pgcopy"): an 11 byte signature, int32 flags and
+    //header extension length, then per tuple an int16 field count and int32 length prefixed
+    //fields (-1 for a null), all big-endian, and an int16 -1 after the last tuple. INT is
+    //int8, REAL float8, STRING text, DATE date (days since 2000-01-01), TIMESTAMP timestamp
+    //(microseconds since 2000-01-01 00:00:00) and DECIMAL numeric; dates and times are the
+    //local wall clock the text output shows.
+    static const int_fast64_t PGCOPY_EPOCH_DAYS = 10957;
+
+    inline void append_big_endian(string& out, const uint_fast64_t value, const unsigned int bytes)
     {
-    private:
-         uint_fast16_t string_length;
-         bool var_length;
-         rand_str_generator<>* rand_str_gen = nullptr;
-    public:
-        comp_pk_string_column(prng_engine<uint_fast64_t>& prng, const table& table, const string& col_name, 
-            const uint_fast64_t prng_seed, const uint_fast64_t amount, const uint_fast64_t max, 
-            const uint_fast64_t repeat_window, const uint_fast64_t group_size, const uint_fast16_t str_length,
-            const bool var_length) :
-            comp_pk_int_column(prng, table, col_name, prng_seed, amount, max, repeat_window, group_size), 
-            string_length(str_length), var_length(var_length)
-        {
-            comp_pk_int_column::column::set_data_type(redgene_types::STRING);
-            rand_str_gen = new rand_str_generator<>(str_length, var_length, !var_length);
-        }
+        for(unsigned int i = bytes; i > 0; --i)
+            out += static_cast<char>(value >> ((i - 1) * 8));
+    }
 
-        ~comp_pk_string_column()
-        {
-            if(rand_str_gen)
-                delete rand_str_gen;
-        }
+    inline void append_pgcopy_header(string& out)
+    {
+        out.append("PGCOPY\n\377\r\n\0", 11);
+        append_big_endian(out, 0, 4);
+        append_big_endian(out, 0, 4);
+    }
 
-        uint_fast16_t get_string_length() const
+    inline void append_pgcopy_trailer(string& out)
+    {
+        append_big_endian(out, 0xFFFF, 2);
+    }
+
+    inline void append_pgcopy_null(string& out)
+    {
+        append_big_endian(out, 0xFFFFFFFF, 4);
+    }
+
+    inline void append_pgcopy_text(string& out, const char* data, const size_t size)
+    {
+        append_big_endian(out, size, 4);
+        out.append(data, size);
+    }
+
+    //days since 1970-01-01 of a proleptic Gregorian date
+    inline int_fast64_t days_from_civil(int_fast64_t year, const unsigned int month, const unsigned int day)
+    {
+        year -= month <= 2;
+        int_fast64_t era = (year >= 0 ? year : year - 399) / 400;
+        int_fast64_t year_of_era = year - era * 400;
+        int_fast64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int_fast64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+
+    //numeric: int16 digit count, weight of the first digit, sign and display scale, then
+    //base 10000 digits with the leading and trailing zero digits left out
+    inline void append_pgcopy_numeric(string& out, const int_fast64_t value, const uint_fast8_t scale)
+    {
+        uint_fast64_t magnitude = static_cast<uint_fast64_t>(value);
+        if(value < 0)
+            magnitude = ~magnitude + 1;
+        uint_fast64_t integer = magnitude / DECIMAL_POWERS[scale];
+        uint_fast64_t fraction = magnitude % DECIMAL_POWERS[scale];
+
+        vector<uint_fast16_t> digits;
+        for(; integer; integer /= 10000)
+            digits.insert(digits.begin(), integer % 10000);
+        int_fast16_t weight = static_cast<int_fast16_t>(digits.size()) - 1;
+        //the fraction's decimal digits padded to whole base 10000 digits; as text, since
+        //18 digits padded to 20 do not fit 64 bits
+        string fraction_text;
+        if(scale)
+            append_digits(fraction_text, fraction, scale);
+        fraction_text.append((4 - scale % 4) % 4, '0');
+        for(size_t i = 0; i < fraction_text.size(); i += 4)
+            digits.push_back((fraction_text[i] - '0') * 1000 + (fraction_text[i + 1] - '0') * 100 + 
+                (fraction_text[i + 2] - '0') * 10 + (fraction_text[i + 3] - '0'));
+        size_t first = 0;
+        while(first < digits.size() && digits[first] == 0)
         {
-            return string_length;
+            ++first;
+            --weight;
         }
+        size_t last = digits.size();
+        while(last > first && digits[last - 1] == 0)
+            --last;
+        if(first == last)
+            weight = 0;
+
+        append_big_endian(out, 8 + 2 * (last - first), 4);
+        append_big_endian(out, last - first, 2);
+        append_big_endian(out, static_cast<uint16_t>(weight), 2);
+        append_big_endian(out, (value < 0 && first != last) ? 0x4000 : 0, 2);
+        append_big_endian(out, scale, 2);
+        for(size_t i = first; i < last; ++i)
+            append_big_endian(out, digits[i], 2);
+    }
 
-        bool get_is_var_length() const
+    //one length prefixed field
+    inline void append_pgcopy_value(string& out, const column_vector& values, const uint_fast64_t idx)
+    {
+        if(values.is_null(idx))
         {
-            return var_length;
+            append_pgcopy_null(out);
+            return;
         }
-
-        const string& yield()
+        switch(values.get_type())
         {
-            return (*rand_str_gen)(comp_pk_int_column::yield());
+            case redgene_types::INT:
+                append_big_endian(out, 8, 4);
+                append_big_endian(out, values.get_ints()[idx], 8);
+                break;
+            case redgene_types::REAL:
+            {
+                uint64_t bits;
+                double value = values.get_reals()[idx];
+                memcpy(&bits, &value, sizeof(bits));
+                append_big_endian(out, 8, 4);
+                append_big_endian(out, bits, 8);
+                break;
+            }
+            case redgene_types::STRING:
+            {
+                str_view view = values.get_str(idx);
+                append_pgcopy_text(out, view.data, view.size);
+                break;
+            }
+            case redgene_types::DATE:
+            case redgene_types::TIMESTAMP:
+            {
+                time_t time_val = values.get_times()[idx];
+                struct tm ltm;
+                localtime_r(&time_val, &ltm);
+                int_fast64_t days = days_from_civil(1900 + ltm.tm_year, ltm.tm_mon + 1, ltm.tm_mday) -
+                    PGCOPY_EPOCH_DAYS;
+                if(values.get_type() == redgene_types::DATE)
+                {
+                    append_big_endian(out, 4, 4);
+                    append_big_endian(out, static_cast<uint_fast64_t>(days), 4);
+                }
+                else
+                {
+                    int_fast64_t seconds = days * 86400 + ltm.tm_hour * 3600 + ltm.tm_min * 60 + ltm.tm_sec;
+                    append_big_endian(out, 8, 4);
+                    append_big_endian(out, static_cast<uint_fast64_t>(seconds * 1000000), 8);
+                }
+                break;
+            }
+            case redgene_types::DECIMAL:
+                append_pgcopy_numeric(out, values.get_decimals()[idx], values.get_scale());
+                break;
         }
-    };
+    }
 
-    //COMP_FK classes
-    class comp_fk_int_column : public column
+    //binary COPY tuples of the batch
+    inline void append_pgcopy_rows(string& out, const row_batch& batch)
     {
-    private:
-        prng_engine<uint_fast64_t> prng;
-        const table& _table;
-        const uint_fast64_t repeat_window;
-        const uint_fast64_t group_size;
-        const float cardinality;
-        const skewness skew;
-        vector<uint_fast64_t>* comp_pk_set_dist_vector = nullptr;
-        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+        for(uint_fast64_t row = 0; row < batch.size(); ++row)
+        {
+            append_big_endian(out, batch.column_count(), 2);
+            for(size_t col = 0; col < batch.column_count(); ++col)
+                append_pgcopy_value(out, batch.column(col), row);
+        }
+    }
+
+    //COLUMN ATTRIBUTES SECTION
+    class column : public arena_object
+    {
+    protected:
+        const string col_name;
+        mutable redgene_types data_type;
+        const constraints constraint;
+        //stream of the column when the prng is counter based
+        uint_fast32_t stream_id = 0;
+        //null bits of the column, when it has a null_ratio
+        bulk_bernoulli* null_bits = nullptr;
     public:
-        comp_fk_int_column(prng_engine<uint_fast64_t>& _prng, const table& _table, const string& col_name,
-            const uint_fast64_t prng_seed, const uint_fast64_t amount, const uint_fast64_t max, 
-            const uint_fast64_t repeat_window, const uint_fast64_t group_size, const float cardinality,
-            const skewness skew) : prng(_prng), _table(_table), column(col_name, redgene_types::INT,
-            constraints::COMP_FK), repeat_window(repeat_window), group_size(group_size), 
-            cardinality(cardinality), skew(skew), comp_pk_set_dist_vector(new vector<uint_fast64_t>(amount))
+        column(const string& col_name, const redgene_types data_type,
+            const constraints constraint) : 
+            col_name(col_name), data_type(data_type), constraint(constraint)
         {
-            //repopulate all COMP_PK set distribution vector
-            prng.seed(prng_seed);
-            set_distribution<uint_fast64_t> set_dist_pdf(prng, amount, max);
-            for(uint_fast64_t i = 0; i < amount; ++i)
-                (*comp_pk_set_dist_vector)[i] = set_dist_pdf();
 
-            if(skew == skewness::NO)
+        }
+        string column_name() const
+        {
+            return col_name;
+        }
+
+        redgene_types get_type() const
+        {
+            return data_type;
+        }
+
+        constraints get_constraint_type() const
+        {
+            return constraint;
+        }
+
+        void set_data_type(redgene_types data_type)
+        {
+            this->data_type = data_type;
+        }
+
+        uint_fast32_t get_stream_id() const
+        {
+            return stream_id;
+        }
+
+        void set_stream_id(uint_fast32_t stream_id)
+        {
+            this->stream_id = stream_id;
+        }
+
+        //null bits are keyed by the stream id, so set that first
+        void set_null_ratio(const double null_ratio, const uint_fast64_t seed)
+        {
+            arena_delete(null_bits);
+            null_bits = arena_new<bulk_bernoulli>(null_ratio, seed, stream_id);
+        }
+
+        const bulk_bernoulli* get_null_bits() const
+        {
+            return null_bits;
+        }
+
+        //generation position of the column, written into checkpoint manifests
+        virtual void save_state(ostream& os) const = 0;
+        virtual void load_state(istream& is) = 0;
+
+        //positions the column on the given row in O(1); the random part of the
+        //value can only be positioned when the prng is counter based.
+        virtual void seek(uint_fast64_t row) = 0;
+
+        //appends the next value of the column to a batch
+        virtual void yield_into(column_vector& values) = 0;
+
+        //appends rows [first_row, first_row + rows), each from its own position of the
+        //column's stream; used with counter based prngs, where columns are independent
+        virtual void yield_batch(column_vector& values, const uint_fast64_t first_row, 
+            const uint_fast64_t rows)
+        {
+            for(uint_fast64_t row = first_row; row < first_row + rows; ++row)
             {
-                pdfuncbase = new uniform_int_dist_engine<>(prng, 1, cardinality);
+                seek(row);
+                yield_into(values);
             }
-            else
-                pdfuncbase = new zipf_distribution<>(prng, cardinality, get_alpha_value(skew));
         }
 
-        ~comp_fk_int_column()
+        //derived columns are computed from another column of the batch, not yielded
+        virtual bool is_derived() const
         {
-            if(comp_pk_set_dist_vector)
-                delete comp_pk_set_dist_vector;
-            if(pdfuncbase)
-                delete pdfuncbase;
+            return false;
         }
 
-        inline uint_fast64_t yield()
-        {   
-            uint_fast64_t index = (*pdfuncbase)()-1;
-            uint_fast64_t set_vector_val = (*comp_pk_set_dist_vector)[index];
-            set_vector_val %= repeat_window;
-            if(set_vector_val == 0)
-                set_vector_val = repeat_window;
-            return ceil((double)set_vector_val / group_size);
+        virtual ~column()
+        {
+            arena_delete(null_bits);
         }
     };
 
-    class comp_fk_string_column :public comp_fk_int_column
+    //KERNEL SECTION
+    //INT and STRING columns draw a key per row: its position for a unique column, a drawn
+    //value otherwise, and for a cardinality below 1 the positions first and drawn values
+    //after. With a counter based prng the column builds a key_kernel for its mode and
+    //distribution when it is created, so filling a batch is one virtual call; the loop below
+    //it has no mode check and draws from the concrete distribution and engine inline.
+    using cardinality_modes = enum cardinality_modes { UNIQUE, RATIO, ABSOLUTE };
+    typedef philox4x32_prng<uint_fast64_t> counter_engine;
+
+    //the counter based engine as a standard uniform random bit generator, its draws are not
+    //virtual calls as the engine class is final
+    struct counter_bits
     {
-    private:
-        uint_fast16_t string_length;
-        bool var_length;
-        rand_str_generator<>* rand_str_gen = nullptr;
-    public:
-        comp_fk_string_column(prng_engine<uint_fast64_t>& _prng, const table& _table, const string& col_name,
-            const uint_fast64_t prng_seed, const uint_fast64_t amount, const uint_fast64_t max, 
-            const uint_fast64_t repeat_window, const uint_fast64_t group_size, const float cardinality,
-            const skewness skew, const uint_fast16_t str_length, const bool var_length) :
-            comp_fk_int_column(_prng, _table, col_name, prng_seed, amount, max, repeat_window, group_size,
-            cardinality, skew), string_length(str_length), var_length(var_length)
+        typedef uint_fast64_t result_type;
+        counter_engine& engine;
+
+        static constexpr result_type min()
         {
-            comp_fk_int_column::column::set_data_type(redgene_types::STRING);
-            //since this is FK column we will not bypass string warehouse check.
-            rand_str_gen = new rand_str_generator<>(string_length, var_length, false);
+            return 0;
         }
 
-        ~comp_fk_string_column()
+        static constexpr result_type max()
         {
-            if(rand_str_gen)
-                delete rand_str_gen;
+            return 0xFFFFFFFF;
         }
 
-        const string& yield()
+        inline result_type operator()()
         {
-            return (*rand_str_gen)(comp_fk_int_column::yield());
+            return engine();
         }
     };
 
-
-    class redgene_engine
+    class key_kernel : public arena_object
     {
-    private:    
-        redgene_validator& rgene_validator;
-        prng_engine<uint_fast64_t>* prng = nullptr;
-        map<string, table*> schema_map;
-        uint_fast64_t g_prng_seed;
+    public:
+        //keys of rows [first_row, first_row + rows) of the column stream stream_id
+        virtual void fill(uint_fast64_t* keys, const uint_fast64_t first_row, const uint_fast64_t rows,
+            const uint_fast32_t stream_id) = 0;
+        virtual ~key_kernel() = default;
+    };
 
-        //members to track comp_pk columns
-        typedef struct comp_pk_attributes
+    //UNIQUE: every key is its row's position
+    class position_key_kernel final : public key_kernel
+    {
+    public:
+        void fill(uint_fast64_t* keys, const uint_fast64_t first_row, const uint_fast64_t rows,
+            const uint_fast32_t)
         {
-            uint_fast64_t repeat_window;
-            uint_fast64_t group_size;
-        } comp_pk_attributes;
-        bool is_comp_pk_map_available = false;
-        map<string, comp_pk_attributes*>* comp_pk_attrib_map = nullptr;
+            for(uint_fast64_t k = 0; k < rows; ++k)
+                keys[k] = first_row + k + 1;
+        }
+    };
+
+    //RATIO and ABSOLUTE, the drawn keys come from dist_type on the counter based engine
+    template <typename dist_type, cardinality_modes mode>
+    class key_kernel_impl final : public key_kernel
+    {
+    private:
+        counter_bits bits;
+        dist_type dist;
+        //rows taking their position, RATIO only
+        const uint_fast64_t position_rows;
     public:
-        redgene_engine() = delete;
-        redgene_engine(redgene_validator& rgene_validator) :
-            rgene_validator(rgene_validator)
+        template <typename... dist_args>
+        key_kernel_impl(counter_engine& engine, const uint_fast64_t position_rows, dist_args... args) :
+            bits{engine}, dist(bits, args...), position_rows(position_rows)
         {
 
         }
-        ~redgene_engine()
-        {
-            if(prng)
-                delete prng;
 
-            for(auto table : schema_map)
+        void fill(uint_fast64_t* keys, const uint_fast64_t first_row, const uint_fast64_t rows,
+            const uint_fast32_t stream_id)
+        {
+            uint_fast64_t i = 0;
+            if(mode == cardinality_modes::RATIO && first_row < position_rows)
+                i = min(rows, position_rows - first_row);
+            for(uint_fast64_t k = 0; k < i; ++k)
+                keys[k] = first_row + k + 1;
+            for(; i < rows; ++i)
             {
-                for(auto column : table.second->get_column_map())
-                {
-                    delete column.second;
-                }
-                delete table.second;
+                bits.engine.seek(stream_id, first_row + i);
+                keys[i] = dist();
             }
         }
-        void generate()
+    };
+
+    //the kernel of an INT or STRING column of the given cardinality, nullptr unless the prng
+    //is counter based; the draws equal those of the column's own distributions
+    inline key_kernel* make_key_kernel(prng_engine<uint_fast64_t>& prng, const float cardinality,
+        const skewness skew, const uint_fast64_t table_rows)
+    {
+        if(!prng.is_counter_based())
+            return nullptr;
+        counter_engine& engine = static_cast<counter_engine&>(prng.get_base());
+        typedef uniform_int_dist_engine<uint_fast64_t, uint_fast64_t, counter_bits> uniform_dist;
+        typedef zipf_distribution<uint_fast64_t, uint_fast64_t, counter_bits> zipf_dist;
+
+        if(cardinality == 1)
+            return new position_key_kernel();
+        if(cardinality < 1)
         {
-            generate_redgene_structures();
+            uint_fast64_t position_rows = table_rows*cardinality;
+            if(skew == skewness::NO)
+                return new key_kernel_impl<uniform_dist, cardinality_modes::RATIO>(engine, position_rows,
+                    static_cast<uint_fast64_t>(1), static_cast<uint_fast64_t>(table_rows*cardinality));
+            return new key_kernel_impl<zipf_dist, cardinality_modes::RATIO>(engine, position_rows,
+                static_cast<uint_fast64_t>(table_rows*cardinality), static_cast<double>(get_alpha_value(skew)));
         }
+        if(skew == skewness::NO)
+            return new key_kernel_impl<uniform_dist, cardinality_modes::ABSOLUTE>(engine, 0,
+                static_cast<uint_fast64_t>(1), static_cast<uint_fast64_t>(cardinality));
+        return new key_kernel_impl<zipf_dist, cardinality_modes::ABSOLUTE>(engine, 0,
+            static_cast<uint_fast64_t>(cardinality), static_cast<double>(get_alpha_value(skew)));
+    }
+
+    //SECTION-1: NORMAL COLUMN GENERATION CLASSES
+    class normal_int_column : public column
+    {
     private:
-        void generate_redgene_structures()
+        prng_engine<uint_fast64_t>& prng;
+        const table& _table;
+        float cardinality;
+        const skewness skew;
+
+        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+        key_kernel* kernel = nullptr;
+
+        //Members to support cardinality specification between 0 and 1
+        prob_dist_base<uint_fast64_t>* support_pdf_lt1card = nullptr;
+        uint_fast64_t call_index = 0;
+        uint_fast64_t lt1card_count = 0;
+
+        void set_pdf_context()
         {
-            if(rgene_validator.is_valid())
-            {
-                set_prng_engine();
-                set_table_metadata();
-                datagen();
+            kernel = make_key_kernel(prng, cardinality, skew, _table.get_row_count());
+            if(cardinality == 1)
+                pdfuncbase = new simple_incrementer<uint_fast64_t>();
+            else if(cardinality < 1)
+            {   
+                call_index = lt1card_count = _table.get_row_count()*cardinality;
+                support_pdf_lt1card = new simple_incrementer<uint_fast64_t>();
+
+                if(skew == skewness::NO)
+                    pdfuncbase = new uniform_int_dist_engine<uint_fast64_t, uint_fast64_t>(prng, 1,
+                        (_table.get_row_count()*cardinality));
+                else
+                    pdfuncbase = new zipf_distribution<uint_fast64_t, uint_fast64_t>(prng,
+                        _table.get_row_count()*cardinality, get_alpha_value(skew));
             }
-            else
+            else if(cardinality > 1)
             {
-                throw runtime_error("json file is not ReDGene valid!");
+                if(skew == skewness::NO)
+                    pdfuncbase = new uniform_int_dist_engine<uint_fast64_t, uint_fast64_t>(prng, 1,
+                        cardinality);
+                else
+                    pdfuncbase = new zipf_distribution<uint_fast64_t, uint_fast64_t>(prng,
+                        cardinality, get_alpha_value(skew));
             }
         }
 
-        void set_prng_engine()
+    public:
+        normal_int_column(prng_engine<uint_fast64_t>& prng, const table& table, 
+            const string& col_name, const float cardinality, const skewness skew = skewness::NO) : 
+            column(col_name, redgene_types::INT, constraints::NONE), prng(prng), _table(table), 
+            cardinality(cardinality), skew(skew)
         {
-            json& rgene_json = rgene_validator.get_redgene_valid_json();
-            auto prng_seed = (rgene_json.find("seed") != rgene_json.end()) ?
-                rgene_json.find("seed").value().get<uint_fast64_t>() : 1729;
-            
-            string prng_type = (rgene_json.find("prng") != rgene_json.end()) ? 
-                rgene_json.find("prng").value().get<string>() : "DEFAULT";
-            random_engines prng_engine_type;
-
-            if(prng_type == "MINSTD_RAND0")
-                prng_engine_type = random_engines::MINSTD_RAND0;
-            else if(prng_type == "MINSTD_RAND1")
-                prng_engine_type = random_engines::MINSTD_RAND1;
-            else if(prng_type == "MT19937")
-                prng_engine_type = random_engines::MT19937;
-            else if(prng_type == "MT19937_64")
-                prng_engine_type = random_engines::MT19937_64;
-            else if(prng_type == "RANLUX24")
-                prng_engine_type = random_engines::RANLUX24;
-            else if(prng_type == "RANLUX48")
-                prng_engine_type = random_engines::RANLUX48;
+            set_pdf_context();
+        }
 
-            g_prng_seed = prng_seed;
-            prng = new prng_engine<uint_fast64_t>(prng_engine_type, prng_seed);
+        ~normal_int_column()
+        {
+            delete kernel;
+            delete pdfuncbase;
+            if(support_pdf_lt1card)
+                delete support_pdf_lt1card;
         }
 
-        uint_fast64_t create_nonref_comp_pk_map(json& column_arr, uint_fast64_t row_count)
+        void save_state(ostream& os) const
         {
-            comp_pk_attrib_map =  new map<string, comp_pk_attributes*>();
-            for(auto column : column_arr)
+            os << call_index << ' ';
+            pdfuncbase->save_state(os);
+            if(support_pdf_lt1card)
             {
-                if(column.find("constraint") != column.end())
-                {
-                    if(get_redgene_constraint(column.find("constraint").value().get<string>())
-                        == constraints::COMP_PK)
-                    {
-                        comp_pk_attrib_map->insert(pair<string, comp_pk_attributes*>
-                            (column.find("column_name").value().get<string>(), new comp_pk_attributes));
-                    }
-                }
+                os << ' ';
+                support_pdf_lt1card->save_state(os);
             }
+        }
 
-            //calculate alpha value = pow(4*row_count, 1.0/comp_pk_attrib_map.size())
-            uint_fast64_t alpha = ceil(pow(4*row_count, 1.0/comp_pk_attrib_map->size()));
+        void load_state(istream& is)
+        {
+            is >> call_index;
+            pdfuncbase->load_state(is);
+            if(support_pdf_lt1card)
+                support_pdf_lt1card->load_state(is);
+        }
 
-            uint_fast16_t index = 0;
-            for(auto column : column_arr)
+        void seek(uint_fast64_t row)
+        {
+            if(prng.is_counter_based())
+                prng.seek(stream_id, row);
+            pdfuncbase->seek(row);
+            if(support_pdf_lt1card)
             {
-                if(column.find("constraint") != column.end())
-                {
-                    if(get_redgene_constraint(column.find("constraint").value().get<string>())
-                        == COMP_PK)
-                    {
-                        auto comp_pk_attrib_item = comp_pk_attrib_map->find(
-                            column.find("column_name").value().get<string>())->second;
-                        comp_pk_attrib_item->repeat_window = pow(alpha, index + 1);
-                        comp_pk_attrib_item->group_size = pow(alpha, index);
-                        ++index;
-                    }
-                }
+                call_index = (row < lt1card_count) ? lt1card_count - row : 0;
+                support_pdf_lt1card->seek(row);
             }
-            is_comp_pk_map_available = true;
-            return pow(alpha, comp_pk_attrib_map->size());
         }
 
-        uint_fast64_t create_ref_comp_pk_map(json& column_arr)
+        virtual uint_fast64_t yield()
         {
-            uint_fast64_t tmp_group_size = 1;
-            comp_pk_attrib_map = new map<string, comp_pk_attributes*>();
-            for(auto column : column_arr)
+            uint_fast64_t ret_val;
+            if(cardinality < 1)
             {
-                if(column.find("constraint") != column.end())
+                if(call_index > 0)
                 {
-                    if(get_redgene_constraint(column.find("constraint").value().get<string>())
-                        == constraints::COMP_PK)
-                    {
-                        comp_pk_attributes* comp_pk_attrib = new comp_pk_attributes;
-                        comp_pk_attrib->repeat_window = schema_map.find(column.find("ref_tab").value().get<string>())
-                            ->second->get_row_count() * tmp_group_size;
-                        comp_pk_attrib->group_size = tmp_group_size;
-                        tmp_group_size = comp_pk_attrib->repeat_window;
-                        comp_pk_attrib_map->insert(pair<string, comp_pk_attributes*>(column.find("column_name").value().get<string>(),
-                            comp_pk_attrib));
-                    }
+                    ret_val = (*support_pdf_lt1card)();
+                    --call_index;
                 }
+                else
+                    ret_val = (*pdfuncbase)();
             }
-            is_comp_pk_map_available = true;
-            return tmp_group_size;
+            else
+                ret_val = (*pdfuncbase)();
+
+            return ret_val;
         }
 
-        void set_table_metadata()
+        void yield_into(column_vector& values)
         {
-            json& rgene_json = rgene_validator.get_redgene_valid_json();
-            auto table_arr = rgene_json.find("tables");
+            values.append_int(yield());
+        }
 
-            //individual table metadata handling
-            for(auto table_obj : table_arr.value())
-            {
-                auto table_name = table_obj.find("table_name").value().get<string>();
-                auto row_count = table_obj.find("row_count").value().get<uint_fast64_t>();
+        //maps the keys of a batch to the column's values, PK and FK_UNIQUE columns reorder them
+        virtual void map_keys(uint_fast64_t*, const uint_fast64_t)
+        {
 
-                //table object
-                table* table_metadata_obj = new table(table_name, row_count);
+        }
 
-                //logic for individual column types
-                auto column_arr = table_obj.find("columns");
-                uint_fast64_t max_combinations;
-                for(auto column_obj : column_arr.value())
-                {
-                    auto column_name = column_obj.find("column_name").value().get<string>();
-                    auto constraint_obj = column_obj.find("constraint");
-                    redgene_types column_type;
-                    
-                    if(constraint_obj == column_obj.end() || !(rgene_validator.is_ref_constraint(column_obj)))
-                        column_type = get_redgene_type(column_obj.find("type").value().get<string>());
-                    else
-                    {
-                        column_type = schema_map.find(
-                            column_obj.find("ref_tab").value().get<string>())->second->get_column_map().
-                            find(column_obj.find("ref_col").value().get<string>())->second->get_type();
-                    }
+        void yield_batch(column_vector& values, const uint_fast64_t first_row, const uint_fast64_t rows)
+        {
+            if(!kernel)
+                return column::yield_batch(values, first_row, rows);
+            uint_fast64_t* keys = values.extend_ints(rows);
+            kernel->fill(keys, first_row, rows, stream_id);
+            map_keys(keys, rows);
+        }
+    };
 
-                    //column object
-                    column* column_metadata_obj;
+    class normal_real_column : public column
+    {
+    private:
+        prng_engine<uint_fast64_t>& prng;
+        const table& _table;
+        float real_min;
+        float real_max;
+        prob_dist_base<double>* pdfuncbase = nullptr;
+    public:
+        normal_real_column(prng_engine<uint_fast64_t>& prng, const table& table, const string& col_name,
+            const float real_min = 0.0, const float real_max = 1.0) : column(col_name, redgene_types::REAL,
+            constraints::NONE), prng(prng), _table(table), real_min(real_min), real_max(real_max)
+        {
+            pdfuncbase = new uniform_real_dist_engine<uint_fast64_t, double>(prng, 
+                real_min, real_max);
+        }
 
-                    if(column_type == redgene_types::INT)
-                    { 
-                        constraints constraint;
-                        float cardinality;
-                        skewness skew = skewness::NO;
-                        if(column_obj.find("skewness") != column_obj.end())
-                            skew = get_skewness_type(column_obj.find("skewness").value().get<string>());
-                        
-                        if(constraint_obj != column_obj.end())
-                        {
-                            constraint = get_redgene_constraint(constraint_obj.value().get<string>());
-                            if(constraint == constraints::PK)
-                                column_metadata_obj = new pk_int_column(*prng, *table_metadata_obj, column_name);
-                            else if(constraint == constraints::FK)
-                            {
-                                //cardinality needs to be computed, from ref_tab.ref_col
-                                float cardinality = schema_map.find(
-                                    column_obj.find("ref_tab").value().get<string>())->second->get_row_count();
-                
-                                column_metadata_obj = new fk_int_column(*prng, *table_metadata_obj, column_name,
-                                    cardinality, skew);
-                            }
-                            else if(constraint == constraints::FK_UNIQUE)
-                            {
-                                float cardinality = schema_map.find(
-                                    column_obj.find("ref_tab").value().get<string>())->second->get_row_count();
-                                
-                                if(row_count >= cardinality)
-                                {
-                                    row_count = cardinality;
-                                    table_metadata_obj->set_row_count(row_count);
-                                }
-                                column_metadata_obj = new fk_unique_int_column(*prng, *table_metadata_obj, column_name);
-                            }
-                            else if(constraint == constraints::COMP_PK)
-                            {
-                                if(!is_comp_pk_map_available)
-                                {
-                                    if(column_obj.find("type") != column_obj.end())
-                                        max_combinations = create_nonref_comp_pk_map(column_arr.value(), row_count);
-                                    else
-                                        max_combinations = create_ref_comp_pk_map(column_arr.value());
-                                }
-                                auto comp_pk_metadata_obj = comp_pk_attrib_map->find(column_name)->second;
-                                column_metadata_obj = new comp_pk_int_column(*prng, *table_metadata_obj, column_name,
-                                    g_prng_seed, row_count, max_combinations, comp_pk_metadata_obj->repeat_window,
-                                    comp_pk_metadata_obj->group_size);
-                            }
-                            else if(constraint == constraints::COMP_FK)
-                            {
-                                auto comp_pk_tab_metadata = schema_map.find(column_obj.find("ref_tab").value().get<string>())->second;
-                                auto comp_pk_col_metadata = dynamic_cast<comp_pk_int_column*>(comp_pk_tab_metadata->get_column_map()
-                                    .find(column_obj.find("ref_col").value().get<string>())->second);
+        ~normal_real_column()
+        {
+            delete pdfuncbase;
+        }
 
-                                column_metadata_obj = new comp_fk_int_column(*prng, *table_metadata_obj, column_name,
-                                    g_prng_seed, comp_pk_tab_metadata->get_row_count(), comp_pk_col_metadata->get_maxvalue(),
-                                    comp_pk_col_metadata->get_repeat_window(), comp_pk_col_metadata->get_group_size(),
-                                    comp_pk_tab_metadata->get_row_count(), skew);
-                            }
-                        }
-                        else
-                        {
-                            if(column_obj.find("cardinality") != column_obj.end())
-                                cardinality = column_obj.find("cardinality").value().get<float>();
+        void save_state(ostream& os) const
+        {
+            pdfuncbase->save_state(os);
+        }
 
-                            column_metadata_obj = new normal_int_column(*prng, *table_metadata_obj,
-                                column_name, cardinality, skew);
-                        }
-                    }
-                    else if(column_type == redgene_types::STRING)
-                    {
-                        constraints constraint;
-                        uint_fast16_t string_length = 10;
-                        bool var_length = false;
-                        float cardinality;
-                        skewness skew = skewness::NO;
+        void load_state(istream& is)
+        {
+            pdfuncbase->load_state(is);
+        }
 
-                        if(column_obj.find("length") != column_obj.end())
-                            string_length = column_obj.find("length").value().get<uint_fast16_t>();
+        void seek(uint_fast64_t row)
+        {
+            if(prng.is_counter_based())
+                prng.seek(stream_id, row);
+        }
 
-                        if(column_obj.find("var_length") != column_obj.end())
-                            var_length = column_obj.find("var_length").value().get<bool>();
+        inline double yield()
+        {
+            return (*pdfuncbase)();
+        }
 
-                        if(column_obj.find("cardinality") != column_obj.end())
-                            cardinality = column_obj.find("cardinality").value().get<float>();
-                        
-                        if(column_obj.find("skewness") != column_obj.end())
-                            skew = get_skewness_type(column_obj.find("skewness").value().get<string>());
+        void yield_into(column_vector& values)
+        {
+            values.append_real(yield());
+        }
 
-                        if(constraint_obj != column_obj.end())
-                        {
-                            constraint = get_redgene_constraint(constraint_obj.value().get<string>());
-                            if(constraint == constraints::PK)
-                                column_metadata_obj = new pk_string_column(*prng, *table_metadata_obj, column_name,
-                                    string_length, var_length);
-                            else if(constraint == constraints::FK)
-                            {
-                                //cardinality needs to be computed, from ref_tab.ref_col
-                                cardinality = schema_map.find(
-                                    column_obj.find("ref_tab").value().get<string>()
-                                    )->second->get_row_count();
-                                
-                                //str_length needs to be obtained from ref_tab.ref_col
-                                auto ref_col_obj_ref = dynamic_cast<pk_string_column*>((schema_map.find(
-                                    column_obj.find("ref_tab").value().get<string>()
-                                    )->second->get_column_map()).find(column_obj.find("ref_col").value().get<string>())->second);
-                                
-                                string_length = ref_col_obj_ref->get_str_length();
-                                //var_length needs to be obtained from ref_tab.ref_col
-                                var_length = ref_col_obj_ref->get_is_var_length();
+    };
 
-                                column_metadata_obj = new fk_string_column(*prng, *table_metadata_obj, column_name,
-                                    cardinality, string_length, var_length, skew);
-                            }
-                            else if(constraint == constraints::FK_UNIQUE)
-                            {
-                                //cardinality needs to be computed, from ref_tab.ref_col
-                                cardinality = schema_map.find(
-                                    column_obj.find("ref_tab").value().get<string>())->second->get_row_count();
-                                
-                                //str_length needs to be obtained from ref_tab.ref_col
-                                auto ref_col_obj_ref = dynamic_cast<pk_string_column*>((schema_map.find(
-                                    column_obj.find("ref_tab").value().get<string>()
-                                    )->second->get_column_map()).find(column_obj.find("ref_col").value().get<string>())->second);
-                                
-                                string_length = ref_col_obj_ref->get_str_length();
-                                //var_length needs to be obtained from ref_tab.ref_col
-                                var_length = ref_col_obj_ref->get_is_var_length();
+    //DECIMAL(precision, scale) column: int64 counts of 10^-scale units in [real_min, real_max],
+    //uniform over every unit or, with a cardinality, over that many evenly spaced values,
+    //ranked by zipf with a skewness. Only the unscaled integer is generated; the text is
+    //formatted with integer arithmetic by append_decimal_string.
+    class decimal_column : public column
+    {
+    private:
+        prng_engine<uint_fast64_t>& prng;
+        const table& _table;
+        const uint_fast8_t precision;
+        const uint_fast8_t scale;
+        int_fast64_t unit_min;
+        uint_fast64_t step = 1;
+        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+    public:
+        decimal_column(prng_engine<uint_fast64_t>& prng, const table& table, const string& col_name,
+            const uint_fast8_t precision, const uint_fast8_t scale, const double real_min, 
+            const double real_max, const float cardinality = 0, const skewness skew = skewness::NO) :
+            column(col_name, redgene_types::DECIMAL, constraints::NONE), prng(prng), _table(table),
+            precision(precision), scale(scale)
+        {
+            unit_min = llround(real_min * DECIMAL_POWERS[scale]);
+            uint_fast64_t units = llround(real_max * DECIMAL_POWERS[scale]) - unit_min;
+            if(cardinality <= 0)
+            {
+                pdfuncbase = new uniform_int_dist_engine<uint_fast64_t, uint_fast64_t>(prng, 1, units + 1);
+                return;
+            }
+            uint_fast64_t distinct = (cardinality > 1) ? cardinality : 
+                max<uint_fast64_t>(1, _table.get_row_count() * cardinality);
+            distinct = min(distinct, units + 1);
+            step = (distinct > 1) ? units / (distinct - 1) : 0;
+            if(skew == skewness::NO)
+                pdfuncbase = new uniform_int_dist_engine<uint_fast64_t, uint_fast64_t>(prng, 1, distinct);
+            else
+                pdfuncbase = new zipf_distribution<uint_fast64_t, uint_fast64_t>(prng, 
+                    distinct, get_alpha_value(skew));
+        }
 
-                                if(row_count >= cardinality)
-                                {
-                                    row_count = cardinality;
-                                    table_metadata_obj->set_row_count(row_count);
-                                }
-                                column_metadata_obj = new fk_unique_string_column(*prng, *table_metadata_obj,
-                                        column_name, string_length, var_length);
-                            }
-                            else if(constraint == constraints::COMP_PK)
-                            {
-                                if(!is_comp_pk_map_available)
-                                {
-                                    if(column_obj.find("type") != column_obj.end())
-                                        max_combinations = create_nonref_comp_pk_map(column_arr.value(), row_count);
+        ~decimal_column()
+        {
+            delete pdfuncbase;
+        }
+
+        uint_fast8_t get_precision() const
+        {
+            return precision;
+        }
+
+        uint_fast8_t get_scale() const
+        {
+            return scale;
+        }
+
+        void save_state(ostream& os) const
+        {
+            pdfuncbase->save_state(os);
+        }
+
+        void load_state(istream& is)
+        {
+            pdfuncbase->load_state(is);
+        }
+
+        void seek(uint_fast64_t row)
+        {
+            if(prng.is_counter_based())
+                prng.seek(stream_id, row);
+        }
+
+        inline int_fast64_t yield()
+        {
+            return unit_min + static_cast<int_fast64_t>(((*pdfuncbase)() - 1) * step);
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_decimal(yield());
+        }
+    };
+
+    class normal_date_column : public column
+    {
+    private:
+        prng_engine<uint_fast64_t>& prng;
+        const table& _table;
+        const string user_date;
+        uint_fast8_t range_in_years;
+        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+
+        chrono::system_clock::time_point ref_timepoint;
+        chrono::system_clock::time_point adv_timepoint;
+        const uint64_t sec_a_year = 31536000;
+        chrono::seconds interval_in_second;
+
+        //objects to map user-defined date time reference
+        time_t rawtime;
+        struct tm tm_map;
+        string* date_string = nullptr;
+
+    public:
+        normal_date_column(prng_engine<uint_fast64_t>& p_prng, 
+            const table& p_table, const string& p_col_name, 
+            const string p_user_date = redgene::UNIX_TIME_EPOCH, 
+            const uint_fast8_t p_range_in_years = 10) :
+            column(p_col_name, redgene_types::DATE, constraints::NONE),
+            prng(p_prng), _table(p_table), user_date(p_user_date), 
+            range_in_years(p_range_in_years)
+        {
+            if(user_date != redgene::UNIX_TIME_EPOCH)
+            {
+                time(&rawtime);
+                localtime_r(&rawtime, &tm_map);
+                //reference starts at midnight, not at the wall clock time of the run,
+                //so that reruns (resume, row regeneration) see the same dates
+                tm_map.tm_hour = tm_map.tm_min = tm_map.tm_sec = 0;
+                tm_map.tm_isdst = -1;
+                istringstream user_date_str(user_date);
+                user_date_str >> get_time(&tm_map, "%Y-%b-%d");
+                rawtime =  mktime(&tm_map);
+
+                ref_timepoint = chrono::system_clock::from_time_t(rawtime);
+            }
+            adv_timepoint = ref_timepoint + 
+                chrono::seconds(sec_a_year*range_in_years);
+
+            interval_in_second = chrono::duration_cast<chrono::seconds>
+                (adv_timepoint - ref_timepoint);
+            
+            pdfuncbase = new uniform_int_dist_engine<>(prng, 
+                0, interval_in_second.count());
+            date_string = arena_new<string>(11, ' ');
+        }
+
+        //seconds since the epoch
+        inline int_fast64_t yield_time()
+        {
+            return std::chrono::system_clock::to_time_t(
+                ref_timepoint + chrono::seconds((*pdfuncbase)()));
+        }
+
+        const string& yield()
+        {
+            date_string->clear();
+            append_date_string(*date_string, yield_time(), false);
+            return *date_string;
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_time(yield_time());
+        }
+
+        ~normal_date_column()
+        {
+            if(pdfuncbase)
+                delete pdfuncbase;
+            if(date_string)
+                arena_delete(date_string);
+        }
+
+        void save_state(ostream& os) const
+        {
+            pdfuncbase->save_state(os);
+        }
+
+        void load_state(istream& is)
+        {
+            pdfuncbase->load_state(is);
+        }
+
+        void seek(uint_fast64_t row)
+        {
+            if(prng.is_counter_based())
+                prng.seek(stream_id, row);
+        }
+    };
+
+    class normal_timestamp_column : public column
+    {
+    private:
+        prng_engine<uint_fast64_t>& prng;
+        const table& _table;
+        const string user_date;
+        uint_fast8_t range_in_years;
+        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+
+        chrono::system_clock::time_point ref_timepoint;
+        chrono::system_clock::time_point adv_timepoint;
+        const uint64_t sec_a_year = 31536000;
+        chrono::seconds interval_in_second;
+
+        //objects to map user-defined date time reference
+        time_t rawtime;
+        struct tm tm_map;
+        string* date_string = nullptr;
+
+    public:
+        normal_timestamp_column(prng_engine<uint_fast64_t>& p_prng, 
+            const table& p_table, const string& p_col_name, 
+            const string p_user_date = redgene::UNIX_TIME_EPOCH, 
+            const uint_fast8_t p_range_in_years = 10) :
+            column(p_col_name, redgene_types::TIMESTAMP, constraints::NONE),
+            prng(p_prng), _table(p_table), user_date(p_user_date), 
+            range_in_years(p_range_in_years)
+        {
+            if(user_date != redgene::UNIX_TIME_EPOCH)
+            {
+                time(&rawtime);
+                localtime_r(&rawtime, &tm_map);
+                tm_map.tm_isdst = -1;
+                istringstream user_date_str(user_date);
+                user_date_str >> get_time(&tm_map, "%Y-%b-%d %H:%M:%S");
+                rawtime =  mktime(&tm_map);
+
+                ref_timepoint = chrono::system_clock::from_time_t(rawtime);
+            }
+            adv_timepoint = ref_timepoint + 
+                chrono::seconds(sec_a_year*range_in_years);
+
+            interval_in_second = chrono::duration_cast<chrono::seconds>
+                (adv_timepoint - ref_timepoint);
+            
+            pdfuncbase = new uniform_int_dist_engine<>(prng, 
+                0, interval_in_second.count());
+            date_string = arena_new<string>(25, ' ');
+        }
+
+        //seconds since the epoch
+        inline int_fast64_t yield_time()
+        {
+            return std::chrono::system_clock::to_time_t(
+                ref_timepoint + chrono::seconds((*pdfuncbase)()));
+        }
+
+        const string& yield()
+        {
+            date_string->clear();
+            append_date_string(*date_string, yield_time(), true);
+            return *date_string;
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_time(yield_time());
+        }
+
+        ~normal_timestamp_column()
+        {
+            if(pdfuncbase)
+                delete pdfuncbase;
+            if(date_string)
+                arena_delete(date_string);
+        }
+
+        void save_state(ostream& os) const
+        {
+            pdfuncbase->save_state(os);
+        }
+
+        void load_state(istream& is)
+        {
+            pdfuncbase->load_state(is);
+        }
+
+        void seek(uint_fast64_t row)
+        {
+            if(prng.is_counter_based())
+                prng.seek(stream_id, row);
+        }
+    };
+
+    //TIMESTAMP column with "order": "monotonic": row k is the k-th arrival of an event stream
+    //over [start_date, start_date + range_in_years), so the timestamps never decrease. Rows
+    //are cut into blocks of ARRIVAL_BLOCK rows, each owning an equal share of the window, and
+    //a block places its arrivals at the normalized running sums of its gaps; with exponential
+    //gaps these are the arrivals of a Poisson process given the count of the block. Gaps are
+    //hashed from (seed, column, block), so any row range is generated a block at a time with
+    //any prng, and shards, resumes and appends each cover a contiguous time window.
+    //  POISSON: exponential gaps
+    //  BURSTY: 80% short gaps (mean 0.25) and 20% long ones (mean 4), arrivals come in bursts
+    //  DIURNAL: Poisson arrivals in operational time, mapped to real time through the
+    //           inverse of the cumulative rate 1 + DIURNAL_AMPLITUDE cos(time of day - peak_hour)
+    class monotonic_timestamp_column : public column
+    {
+    private:
+        const table& _table;
+        const arrival_processes arrivals;
+        const uint_fast64_t seed;
+        time_t ref_time = 0;
+        //seconds of the window, and operational seconds under the diurnal rate
+        double window;
+        double op_window;
+        //local time of day of the start, less the peak hour, in radians
+        double day_phase = 0;
+        const double omega = 2 * M_PI / 86400;
+
+        //operational seconds per row, set on the first block as the row count may still change
+        double row_width = -1;
+        uint_fast64_t row_count = 0;
+        uint_fast64_t next_row = 0;
+        uint_fast64_t loaded_block = numeric_limits<uint_fast64_t>::max();
+        //seconds since the start of each row of the loaded block
+        vector<double> block_times;
+        string* date_string = nullptr;
+
+        inline double rate(const double t) const
+        {
+            return 1 + DIURNAL_AMPLITUDE * cos(omega * t + day_phase);
+        }
+
+        inline double cumulative_rate(const double t) const
+        {
+            return t + DIURNAL_AMPLITUDE / omega * (sin(omega * t + day_phase) - sin(day_phase));
+        }
+
+        //real time at operational time u; Newton from a nearby guess, kept inside a bracket
+        double real_time(const double u, double t) const
+        {
+            double lo = u - 2 * DIURNAL_AMPLITUDE / omega, hi = u + 2 * DIURNAL_AMPLITUDE / omega;
+            for(int i = 0; i < 64; ++i)
+            {
+                double error = cumulative_rate(t) - u;
+                if(fabs(error) < 1e-3)
+                    break;
+                (error > 0 ? hi : lo) = t;
+                t -= error / rate(t);
+                if(t <= lo || t >= hi)
+                    t = (lo + hi) / 2;
+            }
+            return t;
+        }
+
+        inline double gap(const uint_fast64_t hash) const
+        {
+            double unit = (hash >> 11) * (1.0 / 9007199254740992.0);
+            double length = -log1p(-unit);
+            if(arrivals == arrival_processes::BURSTY)
+                return length * (((hash & 0x3FF) < 205) ? 4.0 : 0.25);
+            return length;
+        }
+
+        void load_block(const uint_fast64_t block)
+        {
+            if(row_width < 0)
+            {
+                row_count = _table.get_row_count();
+                row_width = op_window / max<uint_fast64_t>(1, row_count);
+            }
+            uint_fast64_t key = mix64(seed ^ mix64((static_cast<uint_fast64_t>(stream_id) << 32) ^ block));
+            double sum = 0;
+            for(uint_fast64_t i = 0; i <= ARRIVAL_BLOCK; ++i)
+            {
+                sum += gap(mix64(key + (i + 1) * 0x9E3779B97F4A7C15ULL));
+                if(i < ARRIVAL_BLOCK)
+                    block_times[i] = sum;
+            }
+
+            double start = block * ARRIVAL_BLOCK * row_width;
+            double scale = ARRIVAL_BLOCK * row_width / sum;
+            double previous = start;
+            uint_fast64_t first_row = block * ARRIVAL_BLOCK;
+            for(uint_fast64_t i = 0; i < ARRIVAL_BLOCK; ++i)
+            {
+                double t = start + block_times[i] * scale;
+                if(arrivals == arrival_processes::DIURNAL)
+                    t = previous = real_time(t, previous);
+                //the last block reaches past the window by a fraction of a block, appended
+                //rows beyond the row count carry on after it
+                if(first_row + i < row_count)
+                    t = min(t, window);
+                block_times[i] = t;
+            }
+            loaded_block = block;
+        }
+
+    public:
+        monotonic_timestamp_column(const table& p_table, const string& p_col_name,
+            const string p_user_date, const uint_fast8_t p_range_in_years,
+            const arrival_processes p_arrivals, const double p_peak_hour, const uint_fast64_t p_seed) :
+            column(p_col_name, redgene_types::TIMESTAMP, constraints::NONE),
+            _table(p_table), arrivals(p_arrivals), seed(p_seed), block_times(ARRIVAL_BLOCK)
+        {
+            if(p_user_date != redgene::UNIX_TIME_EPOCH)
+            {
+                time_t rawtime;
+                time(&rawtime);
+                struct tm tm_map;
+                localtime_r(&rawtime, &tm_map);
+                tm_map.tm_isdst = -1;
+                istringstream user_date_str(p_user_date);
+                user_date_str >> get_time(&tm_map, "%Y-%b-%d %H:%M:%S");
+                ref_time = mktime(&tm_map);
+            }
+            window = 31536000.0 * p_range_in_years;
+
+            struct tm ltm;
+            localtime_r(&ref_time, &ltm);
+            day_phase = omega * (ltm.tm_hour * 3600 + ltm.tm_min * 60 + ltm.tm_sec - p_peak_hour * 3600);
+            op_window = (arrivals == arrival_processes::DIURNAL) ? cumulative_rate(window) : window;
+            date_string = arena_new<string>(25, ' ');
+        }
+
+        ~monotonic_timestamp_column()
+        {
+            if(date_string)
+                arena_delete(date_string);
+        }
+
+        //seconds since the epoch
+        inline int_fast64_t yield_time()
+        {
+            uint_fast64_t block = next_row / ARRIVAL_BLOCK;
+            if(block != loaded_block)
+                load_block(block);
+            return ref_time + static_cast<int_fast64_t>(block_times[next_row++ % ARRIVAL_BLOCK]);
+        }
+
+        const string& yield()
+        {
+            date_string->clear();
+            append_date_string(*date_string, yield_time(), true);
+            return *date_string;
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_time(yield_time());
+        }
+
+        void save_state(ostream& os) const
+        {
+            os << next_row;
+        }
+
+        void load_state(istream& is)
+        {
+            is >> next_row;
+        }
+
+        void seek(uint_fast64_t row)
+        {
+            next_row = row;
+        }
+    };
+    
+    class normal_string_column : public column
+    {
+    private:
+        prng_engine<uint_fast64_t>& prng;
+        const table& _table;
+        float cardinality;
+        uint_fast16_t str_length;
+        bool is_var_length;
+        const skewness skew;
+        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+        rand_str_generator<>* rand_str_gen = nullptr;
+        key_kernel* kernel = nullptr;
+        vector<uint_fast64_t> batch_keys;
+
+        //Members to support cardinality specification between 0 and 1
+        prob_dist_base<uint_fast64_t>* support_pdf_lt1card = nullptr;
+        uint_fast64_t call_index = 0;
+        uint_fast64_t lt1card_count = 0;
+
+        void set_pdf_context()
+        {
+            kernel = make_key_kernel(prng, cardinality, skew, _table.get_row_count());
+            if(cardinality == 1)
+                pdfuncbase = new simple_incrementer<>();
+            else if(cardinality < 1)
+            {
+                call_index = lt1card_count = _table.get_row_count()*cardinality;
+                support_pdf_lt1card = new simple_incrementer<uint_fast64_t>();
+
+                if(skew == skewness::NO)
+                    pdfuncbase = new uniform_int_dist_engine<>(prng, 1, 
+                        (_table.get_row_count()*cardinality));
+                else
+                    pdfuncbase = new zipf_distribution<>(prng,
+                        _table.get_row_count()*cardinality, get_alpha_value(skew));
+            }
+            else if(cardinality > 1)
+            {
+                if(skew == skewness::NO)
+                    pdfuncbase = new uniform_int_dist_engine<>(prng, 1,
+                        cardinality);
+                else
+                    pdfuncbase = new zipf_distribution<>(prng,
+                        cardinality, get_alpha_value(skew));
+            }
+
+            if(cardinality >= 0.7 && cardinality <= 1.0)
+            {
+                bool bypass_warehouse_check = !(is_var_length && skew != skewness::NO);
+                rand_str_gen = new rand_str_generator<>(str_length, is_var_length, 
+                    bypass_warehouse_check);
+            }
+            else if((cardinality > 0 && cardinality < 0.7) || cardinality > 1)
+                rand_str_gen = new rand_str_generator<>(str_length, is_var_length, false);
+        }
+    public:
+        normal_string_column(prng_engine<uint_fast64_t>& prng, const table& table, const string& col_name,
+            const float cardinality, const skewness skew = skewness::NO, const uint_fast16_t str_length = 10, 
+            const bool var_length = false) : column(col_name, redgene_types::STRING, constraints::NONE),
+            prng(prng), _table(table), cardinality(cardinality), skew(skew), str_length(str_length), 
+            is_var_length(var_length)
+        {
+            set_pdf_context();
+        }
+
+        ~normal_string_column()
+        {
+            delete kernel;
+            if(rand_str_gen)
+                delete rand_str_gen;
+            if(pdfuncbase)
+                delete pdfuncbase;
+            if(support_pdf_lt1card)
+                delete support_pdf_lt1card;
+        }
+
+        void save_state(ostream& os) const
+        {
+            os << call_index << ' ';
+            pdfuncbase->save_state(os);
+            if(support_pdf_lt1card)
+            {
+                os << ' ';
+                support_pdf_lt1card->save_state(os);
+            }
+        }
+
+        void load_state(istream& is)
+        {
+            is >> call_index;
+            pdfuncbase->load_state(is);
+            if(support_pdf_lt1card)
+                support_pdf_lt1card->load_state(is);
+        }
+
+        void seek(uint_fast64_t row)
+        {
+            if(prng.is_counter_based())
+                prng.seek(stream_id, row);
+            pdfuncbase->seek(row);
+            if(support_pdf_lt1card)
+            {
+                call_index = (row < lt1card_count) ? lt1card_count - row : 0;
+                support_pdf_lt1card->seek(row);
+            }
+        }
+
+        //key of the next string, the string itself is made from it
+        virtual uint_fast64_t yield_key()
+        {
+            uint_fast64_t key_val;
+            if(cardinality < 1)
+            {
+                if(call_index > 0)
+                {
+                    key_val = (*support_pdf_lt1card)();
+                    --call_index;
+                }
+                else
+                    key_val = (*pdfuncbase)();
+            }
+            else
+                key_val = (*pdfuncbase)();
+            return key_val;
+        }
+
+        virtual const string& yield()
+        {
+            return (*rand_str_gen)(yield_key());
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_str(yield());
+        }
+
+        //maps the keys of a batch to the keys of the strings, as yield_key does per row
+        virtual void map_keys(uint_fast64_t*, const uint_fast64_t)
+        {
+
+        }
+
+        void yield_batch(column_vector& values, const uint_fast64_t first_row, const uint_fast64_t rows)
+        {
+            if(!kernel)
+                return column::yield_batch(values, first_row, rows);
+            batch_keys.resize(rows);
+            kernel->fill(batch_keys.data(), first_row, rows, stream_id);
+            map_keys(batch_keys.data(), rows);
+            for(uint_fast64_t i = 0; i < rows; ++i)
+                values.append_str((*rand_str_gen)(batch_keys[i]));
+        }
+
+        uint_fast16_t get_str_length() const
+        {
+            return str_length;
+        }
+
+        bool get_is_var_length() const
+        {
+            return is_var_length;
+        }
+    };
+
+    //Order in which a PK column emits its keys 1..row_count: sequential, or the n-th row takes
+    //the key at position n of a run_permutation, with runs of one key ("random") or of
+    //run_length keys ("clustered_runs"). The key domain stays 1..row_count, so FK columns
+    //reference it unchanged, and no key list is kept.
+    class pk_key_order
+    {
+    private:
+        const table& _table;
+        uint_fast64_t run_length;
+        uint_fast64_t seed;
+        run_permutation* key_order = nullptr;
+    public:
+        //run_length 0 is sequential
+        pk_key_order(const table& table, const string& col_name, const uint_fast64_t run_length,
+            const uint_fast64_t seed) : _table(table), run_length(run_length), 
+            seed(column_seed(seed, table.get_table_name(), col_name))
+        {
+
+        }
+
+        ~pk_key_order()
+        {
+            arena_delete(key_order);
+        }
+
+        //the permutation is made on first use, once a FK_UNIQUE column of the table may
+        //have lowered its row count
+        inline uint_fast64_t operator()(const uint_fast64_t position)
+        {
+            if(run_length == 0)
+                return position;
+            if(!key_order)
+                key_order = arena_new<run_permutation>(_table.get_row_count(), run_length, seed);
+            return (*key_order)(position - 1) + 1;
+        }
+    };
+
+    class pk_int_column : public normal_int_column
+    {
+    private:
+        pk_key_order key_order;
+    public:
+        pk_int_column(prng_engine<uint_fast64_t>& prng, const table& table,
+            const string& col_name, const uint_fast64_t run_length = 0, const uint_fast64_t seed = 0) : 
+            normal_int_column(prng, table, col_name, 1), key_order(table, col_name, run_length, seed)
+        {
+
+        }
+        
+        ~pk_int_column() = default;
+
+        virtual inline uint_fast64_t yield()
+        {
+            return key_order(this->normal_int_column::yield());
+        }
+
+        void map_keys(uint_fast64_t* keys, const uint_fast64_t rows)
+        {
+            for(uint_fast64_t i = 0; i < rows; ++i)
+                keys[i] = key_order(keys[i]);
+        }
+    };
+
+    class pk_string_column : public normal_string_column
+    {
+    private:
+        pk_key_order key_order;
+    public:
+        pk_string_column(prng_engine<uint_fast64_t>& prng, const table& table,
+            const string& col_name, const uint_fast16_t str_length = 10, 
+            const bool var_length = false, const uint_fast64_t run_length = 0, const uint_fast64_t seed = 0) : 
+            normal_string_column(prng, table, col_name, 1, skewness::NO, str_length, var_length),
+            key_order(table, col_name, run_length, seed)
+        {
+
+        }
+
+        ~pk_string_column() = default;
+
+        uint_fast64_t yield_key()
+        {
+            return key_order(normal_string_column::yield_key());
+        }
+
+        void map_keys(uint_fast64_t* keys, const uint_fast64_t rows)
+        {
+            for(uint_fast64_t i = 0; i < rows; ++i)
+                keys[i] = key_order(keys[i]);
+        }
+    };
+    
+    class fk_int_column : public normal_int_column
+    {
+    private:
+        float fk_cardinality;
+    public:
+        fk_int_column(prng_engine<uint_fast64_t>& prng, const table& table,
+            const string& col_name, const float cardinality, const skewness skew = skewness::NO)
+            : normal_int_column(prng, table, col_name, cardinality, skew), fk_cardinality(cardinality)
+        {
+
+        }
+
+        ~fk_int_column() = default;
+
+        virtual inline uint_fast64_t yield()
+        {
+            return normal_int_column::yield();
+        }
+    };
+
+    class fk_string_column : public normal_string_column
+    {
+    private:
+        float cardinality;
+        uint_fast16_t str_length;
+        bool var_length;
+    public:
+        fk_string_column(prng_engine<uint_fast64_t>& prng, const table& table,
+            const string& col_name, const float cardinality, const uint_fast16_t str_length, 
+            const bool var_length, const skewness skew = skewness::NO) :
+            normal_string_column(prng, table, col_name, cardinality, skew, str_length, var_length)
+        {
+
+        }
+
+        ~fk_string_column() = default;
+
+        virtual const string& yield()
+        {
+            return normal_string_column::yield();
+        }
+    };
+
+    //FK_UNIQUE columns take the parent keys 1, 2, 3, ... in order, or with "fk_order": "random"
+    //the n-th row takes the parent key at position n of a pseudo random permutation of the
+    //parent's rows, which needs no memory and can be computed for any row on its own
+    class fk_key_order
+    {
+    private:
+        feistel_permutation* key_order = nullptr;
+    public:
+        //parent_rows 0 keeps the parent keys in order
+        fk_key_order(const table& table, const string& col_name, const uint_fast64_t parent_rows,
+            const uint_fast64_t seed)
+        {
+            if(parent_rows > 0)
+                key_order = arena_new<feistel_permutation>(parent_rows,
+                    column_seed(seed, table.get_table_name(), col_name));
+        }
+
+        ~fk_key_order()
+        {
+            arena_delete(key_order);
+        }
+
+        inline uint_fast64_t operator()(const uint_fast64_t position) const
+        {
+            return key_order ? (*key_order)(position - 1) + 1 : position;
+        }
+    };
+
+    class fk_unique_int_column : public normal_int_column
+    {
+    private:
+        fk_key_order key_order;
+    public:
+        fk_unique_int_column(prng_engine<uint_fast64_t>& prng, const table& table, 
+            const string& col_name, const uint_fast64_t parent_rows = 0, const uint_fast64_t seed = 0) :
+            normal_int_column(prng, table, col_name, 1), key_order(table, col_name, parent_rows, seed)
+        {
+
+        }
+
+        ~fk_unique_int_column() = default;
+
+        inline uint_fast64_t yield()
+        {
+            return key_order(normal_int_column::yield());
+        }
+
+        void map_keys(uint_fast64_t* keys, const uint_fast64_t rows)
+        {
+            for(uint_fast64_t i = 0; i < rows; ++i)
+                keys[i] = key_order(keys[i]);
+        }
+    };
+
+    class fk_unique_string_column : public normal_string_column
+    {
+    private:
+        fk_key_order key_order;
+    public:
+        fk_unique_string_column(prng_engine<uint_fast64_t>& prng, const table& table,
+            const string& col_name, const uint_fast16_t str_length, const bool var_length,
+            const uint_fast64_t parent_rows = 0, const uint_fast64_t seed = 0) :
+            normal_string_column(prng, table, col_name, 1, skewness::NO, str_length, var_length),
+            key_order(table, col_name, parent_rows, seed)
+        {
+
+        }
+
+        ~fk_unique_string_column() = default;
+
+        uint_fast64_t yield_key()
+        {
+            return key_order(normal_string_column::yield_key());
+        }
+
+        void map_keys(uint_fast64_t* keys, const uint_fast64_t rows)
+        {
+            for(uint_fast64_t i = 0; i < rows; ++i)
+                keys[i] = key_order(keys[i]);
+        }
+    };
+
+    //int composite primary key class
+    class comp_pk_int_column : public column
+    {
+    private:
+        prng_engine<uint_fast64_t>& prng;
+        const table& _table;
+        
+        const uint_fast64_t amount;
+        const uint_fast64_t max;
+        const uint_fast64_t repeat_window;
+        const uint_fast64_t group_size;
+
+        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+    public:
+        comp_pk_int_column(prng_engine<uint_fast64_t>& prng, const table& _table, const string& col_name,
+            const uint_fast64_t prng_seed, const uint_fast64_t amount, const uint_fast64_t max, 
+            const uint_fast64_t repeat_window, const uint_fast64_t group_size) :
+            prng(prng), _table(_table), column(col_name, redgene_types::INT, constraints::COMP_PK), 
+            amount(amount), max(max), repeat_window(repeat_window), group_size(group_size)
+        {
+            //reset prng to seed value provided.
+            //so that we can have all columns invovled in the comp_pk generation 
+            //be having same random vector to generate the combination of comp_pk values 
+            prng.seed(prng_seed);
+            pdfuncbase = new set_distribution<uint_fast64_t>(prng, amount, max);
+        }
+
+        ~comp_pk_int_column()
+        {
+            if(pdfuncbase)
+                delete pdfuncbase;
+        }
+
+        void save_state(ostream& os) const
+        {
+            pdfuncbase->save_state(os);
+        }
+
+        void load_state(istream& is)
+        {
+            pdfuncbase->load_state(is);
+        }
+
+        void seek(uint_fast64_t row)
+        {
+            pdfuncbase->seek(row);
+        }
+
+        uint_fast64_t get_distinct_count() const
+        {
+            return amount;
+        }
+
+        uint_fast64_t get_maxvalue() const
+        {
+            return max;
+        }
+
+        uint_fast64_t get_repeat_window() const
+        {
+            return repeat_window;
+        }
+
+        uint_fast64_t get_group_size() const
+        {
+            return group_size;
+        }
+
+        inline uint_fast64_t yield()
+        {
+            uint_fast64_t tmp = (*pdfuncbase)();
+            tmp %= repeat_window;
+            if(tmp == 0)
+                tmp = repeat_window;
+            return ceil((double)tmp / group_size);
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_int(yield());
+        }
+    };
+
+    class comp_pk_string_column : public comp_pk_int_column
+    {
+    private:
+         uint_fast16_t string_length;
+         bool var_length;
+         rand_str_generator<>* rand_str_gen = nullptr;
+    public:
+        comp_pk_string_column(prng_engine<uint_fast64_t>& prng, const table& table, const string& col_name, 
+            const uint_fast64_t prng_seed, const uint_fast64_t amount, const uint_fast64_t max, 
+            const uint_fast64_t repeat_window, const uint_fast64_t group_size, const uint_fast16_t str_length,
+            const bool var_length) :
+            comp_pk_int_column(prng, table, col_name, prng_seed, amount, max, repeat_window, group_size), 
+            string_length(str_length), var_length(var_length)
+        {
+            comp_pk_int_column::column::set_data_type(redgene_types::STRING);
+            rand_str_gen = new rand_str_generator<>(str_length, var_length, !var_length);
+        }
+
+        ~comp_pk_string_column()
+        {
+            if(rand_str_gen)
+                delete rand_str_gen;
+        }
+
+        uint_fast16_t get_string_length() const
+        {
+            return string_length;
+        }
+
+        bool get_is_var_length() const
+        {
+            return var_length;
+        }
+
+        const string& yield()
+        {
+            return (*rand_str_gen)(comp_pk_int_column::yield());
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_str(yield());
+        }
+    };
+
+    //COMP_FK classes
+    class comp_fk_int_column : public column
+    {
+    private:
+        prng_engine<uint_fast64_t> prng;
+        const table& _table;
+        const uint_fast64_t repeat_window;
+        const uint_fast64_t group_size;
+        const float cardinality;
+        const skewness skew;
+        vector<uint_fast64_t>* comp_pk_set_dist_vector = nullptr;
+        prob_dist_base<uint_fast64_t>* pdfuncbase = nullptr;
+    public:
+        comp_fk_int_column(prng_engine<uint_fast64_t>& _prng, const table& _table, const string& col_name,
+            const uint_fast64_t prng_seed, const uint_fast64_t amount, const uint_fast64_t max, 
+            const uint_fast64_t repeat_window, const uint_fast64_t group_size, const float cardinality,
+            const skewness skew) : prng(_prng), _table(_table), column(col_name, redgene_types::INT,
+            constraints::COMP_FK), repeat_window(repeat_window), group_size(group_size), 
+            cardinality(cardinality), skew(skew), comp_pk_set_dist_vector(arena_new<vector<uint_fast64_t>>(amount))
+        {
+            //repopulate all COMP_PK set distribution vector
+            prng.seed(prng_seed);
+            set_distribution<uint_fast64_t> set_dist_pdf(prng, amount, max);
+            for(uint_fast64_t i = 0; i < amount; ++i)
+                (*comp_pk_set_dist_vector)[i] = set_dist_pdf();
+
+            if(skew == skewness::NO)
+            {
+                pdfuncbase = new uniform_int_dist_engine<>(prng, 1, cardinality);
+            }
+            else
+                pdfuncbase = new zipf_distribution<>(prng, cardinality, get_alpha_value(skew));
+        }
+
+        ~comp_fk_int_column()
+        {
+            if(comp_pk_set_dist_vector)
+                arena_delete(comp_pk_set_dist_vector);
+            if(pdfuncbase)
+                delete pdfuncbase;
+        }
+
+        //this column draws from its own copy of the prng
+        void save_state(ostream& os) const
+        {
+            prng.save_state(os);
+            os << ' ';
+            pdfuncbase->save_state(os);
+        }
+
+        void load_state(istream& is)
+        {
+            prng.load_state(is);
+            pdfuncbase->load_state(is);
+        }
+
+        void seek(uint_fast64_t row)
+        {
+            if(prng.is_counter_based())
+                prng.seek(stream_id, row);
+        }
+
+        inline uint_fast64_t yield()
+        {   
+            uint_fast64_t index = (*pdfuncbase)()-1;
+            uint_fast64_t set_vector_val = (*comp_pk_set_dist_vector)[index];
+            set_vector_val %= repeat_window;
+            if(set_vector_val == 0)
+                set_vector_val = repeat_window;
+            return ceil((double)set_vector_val / group_size);
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_int(yield());
+        }
+    };
+
+    class comp_fk_string_column :public comp_fk_int_column
+    {
+    private:
+        uint_fast16_t string_length;
+        bool var_length;
+        rand_str_generator<>* rand_str_gen = nullptr;
+    public:
+        comp_fk_string_column(prng_engine<uint_fast64_t>& _prng, const table& _table, const string& col_name,
+            const uint_fast64_t prng_seed, const uint_fast64_t amount, const uint_fast64_t max, 
+            const uint_fast64_t repeat_window, const uint_fast64_t group_size, const float cardinality,
+            const skewness skew, const uint_fast16_t str_length, const bool var_length) :
+            comp_fk_int_column(_prng, _table, col_name, prng_seed, amount, max, repeat_window, group_size,
+            cardinality, skew), string_length(str_length), var_length(var_length)
+        {
+            comp_fk_int_column::column::set_data_type(redgene_types::STRING);
+            //since this is FK column we will not bypass string warehouse check.
+            rand_str_gen = new rand_str_generator<>(string_length, var_length, false);
+        }
+
+        ~comp_fk_string_column()
+        {
+            if(rand_str_gen)
+                delete rand_str_gen;
+        }
+
+        const string& yield()
+        {
+            return (*rand_str_gen)(comp_fk_int_column::yield());
+        }
+
+        void yield_into(column_vector& values)
+        {
+            values.append_str(yield());
+        }
+    };
+
+
+    //PROFILE COLUMN CLASS
+    //profile of a column of real data: the most common values with their frequencies, an
+    //equi-depth histogram over the other values (INT, REAL) and the number of distinct values
+    typedef struct column_profile
+    {
+        vector<uint_fast64_t> mcv_ints;
+        vector<double> mcv_reals;
+        vector<string> mcv_strings;
+        vector<double> mcv_freqs;
+        vector<double> histogram;
+        uint_fast64_t ndv = 0;
+    } column_profile;
+
+    //Column generated to match a profile. An alias table over the mcvs and the histogram
+    //buckets, every bucket holding an equal share of the remaining frequency, picks the source
+    //of each value in O(1); a value inside a bucket is drawn uniformly, on as many points as
+    //the ndv leaves to the bucket. STRING columns spread the remainder over ndv random strings.
+    class profile_column : public column
+    {
+    private:
+        prng_engine<uint_fast64_t>& prng;
+        const table& _table;
+        const column_profile profile;
+        size_t mcv_count;
+        size_t bucket_count = 0;
+        uint_fast64_t rest_ndv = 0;
+        //distinct INT values each bucket draws from
+        vector<uint_fast64_t> bucket_points;
+        alias_distribution<>* source_dist = nullptr;
+        uniform_real_distribution<double> position;
+        rand_str_generator<>* rand_str_gen = nullptr;
+
+        //value at relative position u of bucket b
+        inline uint_fast64_t bucket_int(const size_t b, const double u) const
+        {
+            uint_fast64_t lo = llround(profile.histogram[b]);
+            uint_fast64_t hi = llround(profile.histogram[b + 1]);
+            uint_fast64_t points = bucket_points[b];
+            uint_fast64_t point = min<uint_fast64_t>(u * points, points - 1);
+            return (points == 1) ? lo : lo + point * (hi - lo) / (points - 1);
+        }
+
+        //spreads the ndv over the buckets: equal shares, a bucket narrower than its share
+        //takes all its values and leaves the rest to the wider ones
+        void share_points()
+        {
+            bucket_points.assign(bucket_count, 0);
+            vector<size_t> open;
+            for(size_t b = 0; b < bucket_count; ++b)
+            {
+                uint_fast64_t width = llround(profile.histogram[b + 1]) - llround(profile.histogram[b]) + 1;
+                if(rest_ndv == 0)
+                    bucket_points[b] = width;
+                else
+                    open.push_back(b);
+            }
+            uint_fast64_t remaining = rest_ndv;
+            while(!open.empty())
+            {
+                uint_fast64_t share = max<uint_fast64_t>(1, remaining / open.size());
+                vector<size_t> wider;
+                for(size_t b : open)
+                {
+                    uint_fast64_t width = llround(profile.histogram[b + 1]) - llround(profile.histogram[b]) + 1;
+                    if(width <= share)
+                    {
+                        bucket_points[b] = width;
+                        remaining -= min(remaining, width);
+                    }
+                    else
+                        wider.push_back(b);
+                }
+                if(wider.size() == open.size())
+                {
+                    for(size_t b : wider)
+                        bucket_points[b] = share;
+                    break;
+                }
+                open.swap(wider);
+            }
+        }
+    public:
+        profile_column(prng_engine<uint_fast64_t>& prng, const table& table, const string& col_name,
+            const redgene_types type, const column_profile& profile, const uint_fast16_t str_length = 10,
+            const bool var_length = false) : column(col_name, type, constraints::NONE), prng(prng),
+            _table(table), profile(profile), mcv_count(profile.mcv_freqs.size()), position(0, 1)
+        {
+            double rest = 1;
+            vector<double> weights(profile.mcv_freqs);
+            for(double freq : profile.mcv_freqs)
+                rest -= freq;
+            if(profile.ndv > mcv_count)
+                rest_ndv = profile.ndv - mcv_count;
+
+            if(type == redgene_types::STRING)
+            {
+                //strings are kept once made unless nearly every row has its own, like the
+                //warehouse of normal_string_column
+                rand_str_gen = new rand_str_generator<>(str_length, var_length, 
+                    rest_ndv >= 0.7 * _table.get_row_count());
+                if(rest > 0 && rest_ndv > 0)
+                {
+                    bucket_count = 1;
+                    weights.push_back(rest);
+                }
+            }
+            else if(rest > 0 && profile.histogram.size() > 1)
+            {
+                bucket_count = profile.histogram.size() - 1;
+                weights.insert(weights.end(), bucket_count, rest / bucket_count);
+                if(type == redgene_types::INT)
+                    share_points();
+            }
+            source_dist = new alias_distribution<>(prng, weights);
+        }
+
+        ~profile_column()
+        {
+            delete source_dist;
+            delete rand_str_gen;
+        }
+
+        void save_state(ostream& os) const
+        {
+            source_dist->save_state(os);
+            os << ' ' << position;
+        }
+
+        void load_state(istream& is)
+        {
+            source_dist->load_state(is);
+            is >> position;
+        }
+
+        void seek(uint_fast64_t row)
+        {
+            if(prng.is_counter_based())
+                prng.seek(stream_id, row);
+        }
+
+        void yield_into(column_vector& values)
+        {
+            size_t source = (*source_dist)();
+            if(source < mcv_count)
+            {
+                if(get_type() == redgene_types::INT)
+                    values.append_int(profile.mcv_ints[source]);
+                else if(get_type() == redgene_types::REAL)
+                    values.append_real(profile.mcv_reals[source]);
+                else
+                    values.append_str(profile.mcv_strings[source]);
+                return;
+            }
+
+            size_t b = source - mcv_count;
+            double u = position(prng);
+            if(get_type() == redgene_types::INT)
+                values.append_int(bucket_int(b, u));
+            else if(get_type() == redgene_types::REAL)
+                values.append_real(profile.histogram[b] + 
+                    u * (profile.histogram[b + 1] - profile.histogram[b]));
+            else
+            {
+                //keyed by the stream too, so two columns with the same ndv differ
+                uint_fast64_t key = 1 + min<uint_fast64_t>(u * rest_ndv, rest_ndv - 1);
+                values.append_str((*rand_str_gen)(key | (static_cast<uint_fast64_t>(stream_id) << 40)));
+            }
+        }
+    };
+
+    //DEPENDENT COLUMN CLASS
+    //Column computed from the value of another column in the same row, for correlated data:
+    //FUNCTIONAL maps each parent value to one value (city -> state), OFFSET adds a bounded
+    //random offset to the parent (ship_date after order_date) and CONDITIONAL draws from a
+    //window of `spread` values chosen by the parent value. The whole batch is derived at once
+    //from the parent's vector; random parts are hashed from (seed, column, row), so the
+    //column holds no state and draws nothing from the shared prng.
+    class dependent_column : public column
+    {
+    private:
+        const string parent_name;
+        size_t parent_index = 0;
+        const dependency_modes mode;
+        const uint_fast64_t cardinality;
+        const uint_fast64_t spread;
+        const int_fast64_t min_offset;
+        const int_fast64_t max_offset;
+        const uint_fast64_t seed;
+        //keys the draws of the column, from the seed and its table.column stream
+        uint_fast64_t key = 0;
+        rand_str_generator<>* rand_str_gen = nullptr;
+        vector<uint_fast64_t> parent_keys;
+
+        //one key per parent value, so the modes below are type independent
+        void hash_parent(const column_vector& parent, const uint_fast64_t rows)
+        {
+            parent_keys.resize(rows);
+            switch(parent.get_type())
+            {
+                case redgene_types::INT:
+                    for(uint_fast64_t i = 0; i < rows; ++i)
+                        parent_keys[i] = mix64(parent.get_ints()[i] ^ key);
+                    break;
+                case redgene_types::REAL:
+                    for(uint_fast64_t i = 0; i < rows; ++i)
+                    {
+                        uint64_t bits;
+                        memcpy(&bits, &parent.get_reals()[i], sizeof(bits));
+                        parent_keys[i] = mix64(bits ^ key);
+                    }
+                    break;
+                case redgene_types::STRING:
+                    for(uint_fast64_t i = 0; i < rows; ++i)
+                    {
+                        str_view view = parent.get_str(i);
+                        parent_keys[i] = mix64(fnv1a_hash64(view.data, view.size) ^ key);
+                    }
+                    break;
+                case redgene_types::DECIMAL:
+                    for(uint_fast64_t i = 0; i < rows; ++i)
+                        parent_keys[i] = mix64(static_cast<uint_fast64_t>(parent.get_decimals()[i]) ^ key);
+                    break;
+                default:
+                    for(uint_fast64_t i = 0; i < rows; ++i)
+                        parent_keys[i] = mix64(static_cast<uint_fast64_t>(parent.get_times()[i]) ^ key);
+                    break;
+            }
+        }
+
+        inline uint_fast64_t row_draw(const uint_fast64_t row) const
+        {
+            return mix64(key + row * 0x9E3779B97F4A7C15ULL);
+        }
+
+        void append_value(column_vector& out, const uint_fast64_t value)
+        {
+            if(get_type() == redgene_types::STRING)
+                out.append_str((*rand_str_gen)(value));
+            else
+                out.append_int(value);
+        }
+    public:
+        dependent_column(const string& col_name, const redgene_types type, const string& parent_name,
+            const dependency_modes mode, const uint_fast64_t cardinality, const uint_fast64_t spread,
+            const int_fast64_t min_offset, const int_fast64_t max_offset, const uint_fast64_t seed,
+            const uint_fast16_t str_length = 10, const bool var_length = false) :
+            column(col_name, type, constraints::NONE), parent_name(parent_name), mode(mode),
+            cardinality(max<uint_fast64_t>(1, cardinality)), spread(max<uint_fast64_t>(1, spread)),
+            min_offset(min_offset), max_offset(max_offset), seed(seed)
+        {
+            if(type == redgene_types::STRING)
+                rand_str_gen = new rand_str_generator<>(str_length, var_length);
+        }
+
+        ~dependent_column()
+        {
+            delete rand_str_gen;
+        }
+
+        const string& get_parent_name() const
+        {
+            return parent_name;
+        }
+
+        dependency_modes get_mode() const
+        {
+            return mode;
+        }
+
+        size_t get_parent_index() const
+        {
+            return parent_index;
+        }
+
+        void set_parent_index(const size_t parent_index)
+        {
+            this->parent_index = parent_index;
+        }
+
+        bool is_derived() const
+        {
+            return true;
+        }
+
+        //values of rows [first_row, first_row + rows) from the parent's values of the same rows
+        void derive(const column_vector& parent, column_vector& out, const uint_fast64_t first_row,
+            const uint_fast64_t rows)
+        {
+            key = mix64(seed ^ mix64(static_cast<uint_fast64_t>(stream_id) << 32));
+            uint_fast64_t offset_range = static_cast<uint_fast64_t>(max_offset - min_offset) + 1;
+            if(mode == dependency_modes::OFFSET)
+            {
+                if(get_type() == redgene_types::INT)
+                {
+                    for(uint_fast64_t i = 0; i < rows; ++i)
+                        out.append_int(parent.get_ints()[i] + min_offset + 
+                            row_draw(first_row + i) % offset_range);
+                }
+                else
+                {
+                    int_fast64_t unit = (get_type() == redgene_types::DATE) ? 86400 : 1;
+                    for(uint_fast64_t i = 0; i < rows; ++i)
+                        out.append_time(parent.get_times()[i] + unit * (min_offset + 
+                            static_cast<int_fast64_t>(row_draw(first_row + i) % offset_range)));
+                }
+                return;
+            }
+
+            hash_parent(parent, rows);
+            if(mode == dependency_modes::FUNCTIONAL)
+            {
+                for(uint_fast64_t i = 0; i < rows; ++i)
+                    append_value(out, 1 + parent_keys[i] % cardinality);
+            }
+            else
+            {
+                for(uint_fast64_t i = 0; i < rows; ++i)
+                    append_value(out, 1 + (parent_keys[i] + row_draw(first_row + i) % spread) % cardinality);
+            }
+        }
+
+        void save_state(ostream&) const
+        {
+
+        }
+
+        void load_state(istream&)
+        {
+
+        }
+
+        void seek(uint_fast64_t)
+        {
+
+        }
+
+        void yield_into(column_vector&)
+        {
+            throw runtime_error("dependent column "+col_name+" is derived per batch, not yielded!");
+        }
+    };
+
+    //DELTA SECTION
+    using delta_ops = enum delta_ops { INSERT, UPDATE, DELETE };
+
+    //rows of a table that exist while its delta stream is generated: a bitmap of rows with a
+    //Fenwick tree of live counts per 64 row word, so the k-th live row is found and rows are
+    //added or removed in O(log rows), at about 2 bits per row
+    class live_row_set
+    {
+    private:
+        vector<uint64_t> bits;
+        vector<uint_fast64_t> tree;
+        uint_fast64_t live = 0;
+        size_t top_step = 1;
+
+        void add(const size_t word, const int_fast64_t delta)
+        {
+            for(size_t i = word + 1; i < tree.size(); i += i & (~i + 1))
+                tree[i] += delta;
+        }
+    public:
+        //room for capacity rows, of which [0, initial_rows) are live
+        live_row_set(const uint_fast64_t capacity, const uint_fast64_t initial_rows) :
+            bits((capacity + 63) / 64, 0), tree(bits.size() + 1, 0), live(initial_rows)
+        {
+            for(uint_fast64_t word = 0; word < initial_rows / 64; ++word)
+                bits[word] = ~0ULL;
+            if(initial_rows & 63)
+                bits[initial_rows / 64] = (1ULL << (initial_rows & 63)) - 1;
+
+            //linear build: every node passes its count on to its parent
+            for(size_t i = 1; i < tree.size(); ++i)
+            {
+                for(uint64_t word = bits[i - 1]; word; word &= word - 1)
+                    ++tree[i];
+                size_t parent = i + (i & (~i + 1));
+                if(parent < tree.size())
+                    tree[parent] += tree[i];
+            }
+            while(top_step * 2 < tree.size())
+                top_step *= 2;
+        }
+
+        uint_fast64_t size() const
+        {
+            return live;
+        }
+
+        bool contains(const uint_fast64_t row) const
+        {
+            return (bits[row >> 6] >> (row & 63)) & 1;
+        }
+
+        void insert(const uint_fast64_t row)
+        {
+            bits[row >> 6] |= 1ULL << (row & 63);
+            add(row >> 6, 1);
+            ++live;
+        }
+
+        void erase(const uint_fast64_t row)
+        {
+            bits[row >> 6] &= ~(1ULL << (row & 63));
+            add(row >> 6, -1);
+            --live;
+        }
+
+        //the k-th live row in row order, k < size()
+        uint_fast64_t select(uint_fast64_t k) const
+        {
+            size_t word = 0;
+            for(size_t step = top_step; step; step >>= 1)
+                if(word + step < tree.size() && tree[word + step] <= k)
+                {
+                    word += step;
+                    k -= tree[word];
+                }
+            uint64_t word_bits = bits[word];
+            for(; k; --k)
+                word_bits &= word_bits - 1;
+            return word * 64 + __builtin_ctzll(word_bits);
+        }
+    };
+
+    class batch_reader;
+
+    class redgene_engine
+    {
+        friend class batch_reader;
+    private:    
+        redgene_validator& rgene_validator;
+        prng_engine<uint_fast64_t>* prng = nullptr;
+        map<string, table*> schema_map;
+        uint_fast64_t g_prng_seed;
+        //overrides the "seed" of the schema when set
+        bool has_seed = false;
+        uint_fast64_t seed = 0;
+        //rows added after the end of each table by --append, see append_tables
+        map<string, uint_fast64_t> append_rows;
+
+        //schema with row counts and cardinalities resolved at the scale factor of the run
+        json schema_json;
+        double scale_factor = 0;
+        bool is_resolved = false;
+
+        //members to support checkpoint and resume
+        bool resume = false;
+        uint_fast64_t checkpoint_rows = 1000000;
+        string checkpoint_manifest = CHECKPOINT_MANIFEST;
+
+        //where each table is written, see output_target
+        string output_spec;
+        string writer_mode;
+        //directory created next to the output files that holds them instead, see
+        //set_output_subdirectory
+        string output_subdirectory;
+        //"csv" ('|' delimited text) or "pgcopy" (PostgreSQL binary COPY)
+        string output_format;
+        bool print_stats = false;
+
+        //members to track comp_pk columns
+        typedef struct comp_pk_attributes
+        {
+            uint_fast64_t repeat_window;
+            uint_fast64_t group_size;
+        } comp_pk_attributes;
+        bool is_comp_pk_map_available = false;
+        map<string, comp_pk_attributes*>* comp_pk_attrib_map = nullptr;
+        bool is_prepared = false;
+
+        //unit of work passed between the generate, encode and write stages of write_table
+        typedef struct pipeline_slot
+        {
+            row_batch batch;
+            string text;
+            //holds the last rows of the write, which binary COPY follows with its trailer
+            bool last = false;
+            bool has_checkpoint = false;
+            json checkpoint;
+        } pipeline_slot;
+    public:
+        redgene_engine() = delete;
+        redgene_engine(redgene_validator& rgene_validator) :
+            rgene_validator(rgene_validator)
+        {
+
+        }
+
+        //engine for another seed of the same run: the validated and resolved schema, scale
+        //factor, appends and output settings are taken from setup, only the columns are built
+        //again from the seed
+        redgene_engine(const redgene_engine& setup, const uint_fast64_t seed) :
+            rgene_validator(setup.rgene_validator), has_seed(true), seed(seed),
+            append_rows(setup.append_rows), schema_json(setup.schema_json),
+            scale_factor(setup.scale_factor), is_resolved(setup.is_resolved),
+            output_spec(setup.output_spec), writer_mode(setup.writer_mode),
+            print_stats(setup.print_stats)
+        {
+            if(!is_resolved)
+                throw runtime_error("the schema of the setup engine must be resolved first!");
+        }
+        ~redgene_engine()
+        {
+            if(prng)
+                delete prng;
+
+            for(auto table : schema_map)
+            {
+                for(auto column : table.second->get_column_map())
+                {
+                    delete column.second;
+                }
+                delete table.second;
+            }
+        }
+        //overrides the "output" of the schema, e.g. "-" to stream a single table to stdout
+        void set_output(const string& output_spec)
+        {
+            if(!redgene_validator::is_valid_output(output_spec, 
+                rgene_validator.get_redgene_valid_json().find("tables").value().size()))
+                throw runtime_error("invalid output target "+output_spec+
+                    ", stdout takes a single table, sqlite: a path and shared paths need %t!");
+            this->output_spec = output_spec;
+        }
+
+        //"buffered" writes through the page cache, "direct" uses O_DIRECT with several
+        //asynchronous writes in flight (io_uring, or a pwrite thread pool without it)
+        void set_writer(const string& writer_mode)
+        {
+            if(writer_mode != "buffered" && writer_mode != "direct")
+                throw runtime_error("unknown writer "+writer_mode+", expected buffered or direct!");
+            this->writer_mode = writer_mode;
+        }
+
+        //writes the files (or sqlite database) into a subdirectory of the directory they would
+        //go to, e.g. "%t.csv" into "seed_7/%t.csv", along with the checkpoint manifest
+        void set_output_subdirectory(const string& output_subdirectory)
+        {
+            if(output_subdirectory.empty() || output_subdirectory.find('/') != string::npos)
+                throw runtime_error("output subdirectory "+output_subdirectory+" must be a single name!");
+            this->output_subdirectory = output_subdirectory;
+        }
+
+        //reports rows, bytes, throughput and page cache residency of each table on stderr
+        void set_stats(const bool print_stats)
+        {
+            this->print_stats = print_stats;
+        }
+
+        //the schema as it will be generated, after scaling
+        const json& get_schema()
+        {
+            resolve_schema();
+            return schema_json;
+        }
+
+        double get_scale_factor()
+        {
+            resolve_schema();
+            return scale_factor;
+        }
+
+        //overrides the "scale_factor" of the schema
+        void set_scale_factor(const double scale_factor)
+        {
+            if(scale_factor <= 0)
+                throw runtime_error("scale factor must be greater than 0!");
+            if(is_resolved)
+                throw runtime_error("scale factor must be set before the schema is resolved!");
+            this->scale_factor = scale_factor;
+        }
+
+        //overrides the "seed" of the schema, so a compiled plan serves any seed
+        void set_seed(const uint_fast64_t seed)
+        {
+            if(is_prepared)
+                throw runtime_error("seed must be set before the columns are built!");
+            this->seed = seed;
+            has_seed = true;
+        }
+
+        //generates only rows [row_count, row_count + rows) of the table and appends them to
+        //its output, so a table loaded earlier grows without being regenerated
+        void set_append(const string& table_name, const uint_fast64_t rows)
+        {
+            if(is_prepared)
+                throw runtime_error("appends must be set before the columns are built!");
+            if(rows == 0)
+                throw runtime_error("--append of "+table_name+" needs at least one row!");
+            append_rows[table_name] += rows;
+        }
+
+        //writes the validated schema, resolved at the scale factor, as a compiled plan that
+        //later runs load in place of the schema template, see compiled_plan
+        void compile(const string& plan_filename)
+        {
+            resolve_schema();
+            json plan;
+            plan["scale_factor"] = scale_factor;
+            plan["schema"] = schema_json;
+            compiled_plan::save(plan_filename, plan);
+        }
+
+        //lists the row counts and absolute cardinalities at the scale factor, without
+        //building any column, so it is cheap even for scale factors too large to generate
+        void dry_run(ostream& out)
+        {
+            resolve_schema();
+            out << "scale factor " << scale_factor << endl;
+            uint_fast64_t total_rows = 0;
+            for(auto& table_obj : schema_json.find("tables").value())
+            {
+                auto row_count = table_obj.find("row_count").value().get<uint_fast64_t>();
+                total_rows += row_count;
+                out << table_obj.find("table_name").value().get<string>() << ": " << row_count 
+                    << " rows (" << scaling_rule(table_obj, "linear") << ")" << endl;
+                for(auto& column_obj : table_obj.find("columns").value())
+                {
+                    auto cardinality = column_obj.find("cardinality");
+                    if(cardinality != column_obj.end() && cardinality.value().get<float>() > 1)
+                        out << "    " << column_obj.find("column_name").value().get<string>() 
+                            << ": cardinality " << cardinality.value().get<uint_fast64_t>() 
+                            << " (" << scaling_rule(column_obj, "fixed") << ")" << endl;
+                }
+            }
+            out << "total: " << total_rows << " rows" << endl;
+        }
+
+        void generate(const bool resume = false)
+        {
+            this->resume = resume;
+            generate_redgene_structures();
+        }
+
+        //regenerates a single row of a table without generating the rows before it,
+        //each column is positioned on its own counter based stream, so the cost is O(columns).
+        void generate_row(const string& table_name, const uint_fast64_t row, vector<string>& out)
+        {
+            prepare();
+            if(!prng->is_counter_based())
+                throw runtime_error("random access row generation needs a counter based prng (PHILOX4X32)!");
+
+            auto table_itr = schema_map.find(table_name);
+            if(table_itr == schema_map.end())
+                throw runtime_error("table "+table_name+" is not part of the schema!");
+            if(row >= table_itr->second->get_row_count())
+                throw out_of_range("row "+to_string(row)+" is beyond the row count of "+table_name);
+
+            row_batch batch = make_batch(table_itr->second);
+            fill_batch(table_itr->second, batch, row, 1);
+            out.clear();
+            for(size_t col = 0; col < batch.column_count(); ++col)
+            {
+                string value;
+                append_value_text(value, batch.column(col), 0);
+                out.push_back(value);
+            }
+        }
+
+        //pull based access to the rows of a table as typed column batches, for programs
+        //embedding redgene that want the data without any file being written.
+        batch_reader open_table(const string& table_name, const uint_fast64_t batch_rows = BATCH_ROWS);
+    private:
+        void prepare()
+        {
+            if(is_prepared)
+                return;
+            resolve_schema();
+            set_prng_engine();
+            set_table_metadata();
+            is_prepared = true;
+        }
+
+        void resolve_schema()
+        {
+            if(is_resolved)
+                return;
+            if(!rgene_validator.is_valid())
+                throw runtime_error("json file is not ReDGene valid!");
+            schema_json = rgene_validator.get_redgene_valid_json();
+            //a compiled plan is resolved already, at the scale factor it was compiled for
+            if(rgene_validator.is_compiled())
+            {
+                if(scale_factor != 0 && scale_factor != rgene_validator.get_compiled_scale_factor())
+                    throw runtime_error("plan was compiled at scale factor "+
+                        to_string(rgene_validator.get_compiled_scale_factor())+
+                        ", compile the schema again for another scale factor!");
+                scale_factor = rgene_validator.get_compiled_scale_factor();
+                is_resolved = true;
+                return;
+            }
+            if(scale_factor == 0)
+                scale_factor = (schema_json.find("scale_factor") != schema_json.end()) ?
+                    schema_json.find("scale_factor").value().get<double>() : 1.0;
+
+            //FK ranges and fractional cardinalities follow the scaled row counts by themselves
+            for(auto& table_obj : schema_json.find("tables").value())
+            {
+                auto row_count = table_obj.find("row_count");
+                row_count.value() = scale_count(row_count.value().get<uint_fast64_t>(), 
+                    table_obj, "linear");
+                for(auto& column_obj : table_obj.find("columns").value())
+                {
+                    auto cardinality = column_obj.find("cardinality");
+                    if(cardinality != column_obj.end() && cardinality.value().get<float>() > 1)
+                        cardinality.value() = scale_count(
+                            llround(cardinality.value().get<double>()), column_obj, "fixed");
+                }
+            }
+            is_resolved = true;
+        }
+
+        static string scaling_rule(const json& json_node, const string& default_rule)
+        {
+            return (json_node.find("scaling") != json_node.end()) ?
+                json_node.find("scaling").value().get<string>() : default_rule;
+        }
+
+        //linear scales by the scale factor, sublinear by scale_factor^scale_exponent
+        //(0.5 unless given) and fixed keeps the count
+        uint_fast64_t scale_count(const uint_fast64_t count, const json& json_node, 
+            const string& default_rule)
+        {
+            string rule = scaling_rule(json_node, default_rule);
+            if(rule == "fixed" || scale_factor == 1.0)
+                return count;
+            double exponent = 1.0;
+            if(rule == "sublinear")
+                exponent = (json_node.find("scale_exponent") != json_node.end()) ?
+                    json_node.find("scale_exponent").value().get<double>() : 0.5;
+            return max<uint_fast64_t>(1, llround(count * pow(scale_factor, exponent)));
+        }
+
+        void generate_redgene_structures()
+        {
+            prepare();
+            datagen();
+        }
+
+        void set_prng_engine()
+        {
+            json& rgene_json = schema_json;
+            auto prng_seed = (rgene_json.find("seed") != rgene_json.end()) ?
+                rgene_json.find("seed").value().get<uint_fast64_t>() : 1729;
+            if(has_seed)
+                prng_seed = seed;
+            
+            string prng_type = (rgene_json.find("prng") != rgene_json.end()) ? 
+                rgene_json.find("prng").value().get<string>() : "DEFAULT";
+            random_engines prng_engine_type;
+
+            if(prng_type == "MINSTD_RAND0")
+                prng_engine_type = random_engines::MINSTD_RAND0;
+            else if(prng_type == "MINSTD_RAND1")
+                prng_engine_type = random_engines::MINSTD_RAND1;
+            else if(prng_type == "MT19937")
+                prng_engine_type = random_engines::MT19937;
+            else if(prng_type == "MT19937_64")
+                prng_engine_type = random_engines::MT19937_64;
+            else if(prng_type == "RANLUX24")
+                prng_engine_type = random_engines::RANLUX24;
+            else if(prng_type == "RANLUX48")
+                prng_engine_type = random_engines::RANLUX48;
+            else if(prng_type == "PHILOX4X32")
+                prng_engine_type = random_engines::PHILOX4X32;
+
+            g_prng_seed = prng_seed;
+            prng = new prng_engine<uint_fast64_t>(prng_engine_type, prng_seed);
+        }
+
+        uint_fast64_t create_nonref_comp_pk_map(json& column_arr, uint_fast64_t row_count)
+        {
+            comp_pk_attrib_map = arena_new<map<string, comp_pk_attributes*>>();
+            for(auto& column : column_arr)
+            {
+                if(column.find("constraint") != column.end())
+                {
+                    if(get_redgene_constraint(column.find("constraint").value().get<string>())
+                        == constraints::COMP_PK)
+                    {
+                        comp_pk_attrib_map->insert(pair<string, comp_pk_attributes*>
+                            (column.find("column_name").value().get<string>(), arena_new<comp_pk_attributes>()));
+                    }
+                }
+            }
+
+            //calculate alpha value = pow(4*row_count, 1.0/comp_pk_attrib_map.size())
+            uint_fast64_t alpha = ceil(pow(4*row_count, 1.0/comp_pk_attrib_map->size()));
+
+            uint_fast16_t index = 0;
+            for(auto& column : column_arr)
+            {
+                if(column.find("constraint") != column.end())
+                {
+                    if(get_redgene_constraint(column.find("constraint").value().get<string>())
+                        == COMP_PK)
+                    {
+                        auto comp_pk_attrib_item = comp_pk_attrib_map->find(
+                            column.find("column_name").value().get<string>())->second;
+                        comp_pk_attrib_item->repeat_window = pow(alpha, index + 1);
+                        comp_pk_attrib_item->group_size = pow(alpha, index);
+                        ++index;
+                    }
+                }
+            }
+            is_comp_pk_map_available = true;
+            return pow(alpha, comp_pk_attrib_map->size());
+        }
+
+        uint_fast64_t create_ref_comp_pk_map(json& column_arr)
+        {
+            uint_fast64_t tmp_group_size = 1;
+            comp_pk_attrib_map = arena_new<map<string, comp_pk_attributes*>>();
+            for(auto& column : column_arr)
+            {
+                if(column.find("constraint") != column.end())
+                {
+                    if(get_redgene_constraint(column.find("constraint").value().get<string>())
+                        == constraints::COMP_PK)
+                    {
+                        comp_pk_attributes* comp_pk_attrib = arena_new<comp_pk_attributes>();
+                        comp_pk_attrib->repeat_window = schema_map.find(column.find("ref_tab").value().get<string>())
+                            ->second->get_row_count() * tmp_group_size;
+                        comp_pk_attrib->group_size = tmp_group_size;
+                        tmp_group_size = comp_pk_attrib->repeat_window;
+                        comp_pk_attrib_map->insert(pair<string, comp_pk_attributes*>(column.find("column_name").value().get<string>(),
+                            comp_pk_attrib));
+                    }
+                }
+            }
+            is_comp_pk_map_available = true;
+            return tmp_group_size;
+        }
+
+        //keys per shuffled run for the "pk_order" of a PK column, 0 when sequential
+        static uint_fast64_t get_pk_run_length(json& column_obj)
+        {
+            auto pk_order = column_obj.find("pk_order");
+            if(pk_order == column_obj.end() || pk_order.value().get<string>() == "sequential")
+                return 0;
+            if(pk_order.value().get<string>() == "random")
+                return 1;
+            return (column_obj.find("run_length") != column_obj.end()) ?
+                column_obj.find("run_length").value().get<uint_fast64_t>() : PK_RUN_LENGTH;
+        }
+
+        //"arrivals" of a monotonic TIMESTAMP column, poisson by default
+        static arrival_processes get_arrival_process(json& column_obj)
+        {
+            string arrivals = column_obj.value("arrivals", "poisson");
+            if(arrivals == "bursty")
+                return arrival_processes::BURSTY;
+            if(arrivals == "diurnal")
+                return arrival_processes::DIURNAL;
+            return arrival_processes::POISSON;
+        }
+
+        //"fk_order" of a FK_UNIQUE column, sequential unless "random"
+        static bool is_random_fk_order(json& column_obj)
+        {
+            return column_obj.find("fk_order") != column_obj.end() &&
+                column_obj.find("fk_order").value().get<string>() == "random";
+        }
+
+        column* create_dependent_column(json& column_obj, const string& column_name,
+            const redgene_types column_type, const uint_fast64_t row_count)
+        {
+            auto& depends_on = column_obj.find("depends_on").value();
+            auto mode_string = depends_on.find("mode").value().get<string>();
+            dependency_modes mode = dependency_modes::FUNCTIONAL;
+            if(mode_string == "OFFSET")
+                mode = dependency_modes::OFFSET;
+            else if(mode_string == "CONDITIONAL")
+                mode = dependency_modes::CONDITIONAL;
+
+            //distinct values, with the meaning cardinality has for the other columns
+            uint_fast64_t cardinality = row_count;
+            if(column_obj.find("cardinality") != column_obj.end())
+            {
+                float card = column_obj.find("cardinality").value().get<float>();
+                if(card < 1)
+                    cardinality = row_count * card;
+                else if(card > 1)
+                    cardinality = card;
+            }
+            uint_fast64_t spread = 4;
+            if(depends_on.find("spread") != depends_on.end())
+                spread = depends_on.find("spread").value().get<uint_fast64_t>();
+            int_fast64_t min_offset = 0, max_offset = 0;
+            if(depends_on.find("min_offset") != depends_on.end())
+                min_offset = depends_on.find("min_offset").value().get<int_fast64_t>();
+            if(depends_on.find("max_offset") != depends_on.end())
+                max_offset = depends_on.find("max_offset").value().get<int_fast64_t>();
+
+            uint_fast16_t string_length = 10;
+            bool var_length = false;
+            if(column_obj.find("length") != column_obj.end())
+                string_length = column_obj.find("length").value().get<uint_fast16_t>();
+            if(column_obj.find("var_length") != column_obj.end())
+                var_length = column_obj.find("var_length").value().get<bool>();
+
+            return new dependent_column(column_name, column_type, 
+                depends_on.find("column").value().get<string>(), mode, cardinality, spread,
+                min_offset, max_offset, g_prng_seed, string_length, var_length);
+        }
+
+        column* create_profile_column(table* table_metadata_obj, json& column_obj, 
+            const string& column_name, const redgene_types column_type)
+        {
+            auto& profile_obj = column_obj.find("profile").value();
+            column_profile profile;
+            if(profile_obj.find("mcv") != profile_obj.end())
+                for(auto& mcv_obj : profile_obj.find("mcv").value())
+                {
+                    auto& value = mcv_obj.find("value").value();
+                    if(column_type == redgene_types::INT)
+                        profile.mcv_ints.push_back(value.get<uint_fast64_t>());
+                    else if(column_type == redgene_types::REAL)
+                        profile.mcv_reals.push_back(value.get<double>());
+                    else
+                        profile.mcv_strings.push_back(value.get<string>());
+                    profile.mcv_freqs.push_back(mcv_obj.find("freq").value().get<double>());
+                }
+            if(profile_obj.find("histogram") != profile_obj.end())
+                profile.histogram = profile_obj.find("histogram").value().get<vector<double>>();
+            if(profile_obj.find("ndv") != profile_obj.end())
+                profile.ndv = profile_obj.find("ndv").value().get<uint_fast64_t>();
+
+            uint_fast16_t string_length = 10;
+            bool var_length = false;
+            if(column_obj.find("length") != column_obj.end())
+                string_length = column_obj.find("length").value().get<uint_fast16_t>();
+            if(column_obj.find("var_length") != column_obj.end())
+                var_length = column_obj.find("var_length").value().get<bool>();
+
+            return new profile_column(*prng, *table_metadata_obj, column_name, column_type,
+                profile, string_length, var_length);
+        }
+
+        //points the dependent columns of a table at their parent's position in the batch
+        void resolve_dependencies(table* table_metadata_obj)
+        {
+            auto column_order = table_metadata_obj->get_column_order();
+            auto columns = table_metadata_obj->get_ordered_columns();
+            for(auto col : columns)
+            {
+                if(!col->is_derived())
+                    continue;
+                dependent_column* dep_col = static_cast<dependent_column*>(col);
+                size_t parent_index = find(column_order.begin(), column_order.end(), 
+                    dep_col->get_parent_name()) - column_order.begin();
+                if(parent_index == column_order.size())
+                    throw runtime_error("column "+dep_col->column_name()+" depends on unknown column "
+                        +dep_col->get_parent_name()+"!");
+                //referenced parents only get their type here
+                if(dep_col->get_mode() == dependency_modes::OFFSET && 
+                    columns[parent_index]->get_type() != dep_col->get_type())
+                    throw runtime_error("OFFSET column "+dep_col->column_name()+
+                        " needs a parent of the same type!");
+                dep_col->set_parent_index(parent_index);
+            }
+        }
+
+        void set_table_metadata()
+        {
+            json& rgene_json = schema_json;
+            auto table_arr = rgene_json.find("tables");
+
+            //individual table metadata handling
+            for(auto& table_obj : table_arr.value())
+            {
+                auto table_name = table_obj.find("table_name").value().get<string>();
+                auto row_count = table_obj.find("row_count").value().get<uint_fast64_t>();
+
+                //table object
+                table* table_metadata_obj = new table(table_name, row_count);
+                //the columns of a table and their state are laid out together in its arena
+                arena_scope table_scope(table_metadata_obj->get_arena());
+
+                //logic for individual column types
+                auto column_arr = table_obj.find("columns");
+                uint_fast64_t max_combinations;
+                for(auto& column_obj : column_arr.value())
+                {
+                    auto column_name = column_obj.find("column_name").value().get<string>();
+                    auto constraint_obj = column_obj.find("constraint");
+                    redgene_types column_type;
+                    
+                    if(constraint_obj == column_obj.end() || !(rgene_validator.is_ref_constraint(column_obj)))
+                        column_type = get_redgene_type(column_obj.find("type").value().get<string>());
+                    else
+                    {
+                        column_type = schema_map.find(
+                            column_obj.find("ref_tab").value().get<string>())->second->get_column_map().
+                            find(column_obj.find("ref_col").value().get<string>())->second->get_type();
+                    }
+
+                    //column object
+                    column* column_metadata_obj;
+
+                    if(column_obj.find("depends_on") != column_obj.end())
+                        column_metadata_obj = create_dependent_column(column_obj, column_name,
+                            column_type, row_count);
+                    else if(column_obj.find("profile") != column_obj.end())
+                        column_metadata_obj = create_profile_column(table_metadata_obj, column_obj,
+                            column_name, column_type);
+                    else if(column_type == redgene_types::INT)
+                    { 
+                        constraints constraint;
+                        float cardinality;
+                        skewness skew = skewness::NO;
+                        if(column_obj.find("skewness") != column_obj.end())
+                            skew = get_skewness_type(column_obj.find("skewness").value().get<string>());
+                        
+                        if(constraint_obj != column_obj.end())
+                        {
+                            constraint = get_redgene_constraint(constraint_obj.value().get<string>());
+                            if(constraint == constraints::PK)
+                                column_metadata_obj = new pk_int_column(*prng, *table_metadata_obj, column_name,
+                                    get_pk_run_length(column_obj), g_prng_seed);
+                            else if(constraint == constraints::FK)
+                            {
+                                //cardinality needs to be computed, from ref_tab.ref_col
+                                float cardinality = key_space(column_obj.find("ref_tab").value().get<string>());
+                
+                                column_metadata_obj = new fk_int_column(*prng, *table_metadata_obj, column_name,
+                                    cardinality, skew);
+                            }
+                            else if(constraint == constraints::FK_UNIQUE)
+                            {
+                                float cardinality = schema_map.find(
+                                    column_obj.find("ref_tab").value().get<string>())->second->get_row_count();
+                                
+                                if(row_count >= cardinality)
+                                {
+                                    row_count = cardinality;
+                                    table_metadata_obj->set_row_count(row_count);
+                                }
+                                column_metadata_obj = new fk_unique_int_column(*prng, *table_metadata_obj, column_name,
+                                    is_random_fk_order(column_obj) ? cardinality : 0, g_prng_seed);
+                            }
+                            else if(constraint == constraints::COMP_PK)
+                            {
+                                if(!is_comp_pk_map_available)
+                                {
+                                    if(column_obj.find("type") != column_obj.end())
+                                        max_combinations = create_nonref_comp_pk_map(column_arr.value(), row_count);
+                                    else
+                                        max_combinations = create_ref_comp_pk_map(column_arr.value());
+                                }
+                                auto comp_pk_metadata_obj = comp_pk_attrib_map->find(column_name)->second;
+                                column_metadata_obj = new comp_pk_int_column(*prng, *table_metadata_obj, column_name,
+                                    g_prng_seed, row_count, max_combinations, comp_pk_metadata_obj->repeat_window,
+                                    comp_pk_metadata_obj->group_size);
+                            }
+                            else if(constraint == constraints::COMP_FK)
+                            {
+                                auto comp_pk_tab_metadata = schema_map.find(column_obj.find("ref_tab").value().get<string>())->second;
+                                auto comp_pk_col_metadata = dynamic_cast<comp_pk_int_column*>(comp_pk_tab_metadata->get_column_map()
+                                    .find(column_obj.find("ref_col").value().get<string>())->second);
+
+                                column_metadata_obj = new comp_fk_int_column(*prng, *table_metadata_obj, column_name,
+                                    g_prng_seed, comp_pk_tab_metadata->get_row_count(), comp_pk_col_metadata->get_maxvalue(),
+                                    comp_pk_col_metadata->get_repeat_window(), comp_pk_col_metadata->get_group_size(),
+                                    comp_pk_tab_metadata->get_row_count(), skew);
+                            }
+                        }
+                        else
+                        {
+                            if(column_obj.find("cardinality") != column_obj.end())
+                                cardinality = column_obj.find("cardinality").value().get<float>();
+
+                            column_metadata_obj = new normal_int_column(*prng, *table_metadata_obj,
+                                column_name, cardinality, skew);
+                        }
+                    }
+                    else if(column_type == redgene_types::STRING)
+                    {
+                        constraints constraint;
+                        uint_fast16_t string_length = 10;
+                        bool var_length = false;
+                        float cardinality;
+                        skewness skew = skewness::NO;
+
+                        if(column_obj.find("length") != column_obj.end())
+                            string_length = column_obj.find("length").value().get<uint_fast16_t>();
+
+                        if(column_obj.find("var_length") != column_obj.end())
+                            var_length = column_obj.find("var_length").value().get<bool>();
+
+                        if(column_obj.find("cardinality") != column_obj.end())
+                            cardinality = column_obj.find("cardinality").value().get<float>();
+                        
+                        if(column_obj.find("skewness") != column_obj.end())
+                            skew = get_skewness_type(column_obj.find("skewness").value().get<string>());
+
+                        if(constraint_obj != column_obj.end())
+                        {
+                            constraint = get_redgene_constraint(constraint_obj.value().get<string>());
+                            if(constraint == constraints::PK)
+                                column_metadata_obj = new pk_string_column(*prng, *table_metadata_obj, column_name,
+                                    string_length, var_length, get_pk_run_length(column_obj), g_prng_seed);
+                            else if(constraint == constraints::FK)
+                            {
+                                //cardinality needs to be computed, from ref_tab.ref_col
+                                cardinality = key_space(column_obj.find("ref_tab").value().get<string>());
+                                
+                                //str_length needs to be obtained from ref_tab.ref_col
+                                auto ref_col_obj_ref = dynamic_cast<pk_string_column*>((schema_map.find(
+                                    column_obj.find("ref_tab").value().get<string>()
+                                    )->second->get_column_map()).find(column_obj.find("ref_col").value().get<string>())->second);
+                                
+                                string_length = ref_col_obj_ref->get_str_length();
+                                //var_length needs to be obtained from ref_tab.ref_col
+                                var_length = ref_col_obj_ref->get_is_var_length();
+
+                                column_metadata_obj = new fk_string_column(*prng, *table_metadata_obj, column_name,
+                                    cardinality, string_length, var_length, skew);
+                            }
+                            else if(constraint == constraints::FK_UNIQUE)
+                            {
+                                //cardinality needs to be computed, from ref_tab.ref_col
+                                cardinality = schema_map.find(
+                                    column_obj.find("ref_tab").value().get<string>())->second->get_row_count();
+                                
+                                //str_length needs to be obtained from ref_tab.ref_col
+                                auto ref_col_obj_ref = dynamic_cast<pk_string_column*>((schema_map.find(
+                                    column_obj.find("ref_tab").value().get<string>()
+                                    )->second->get_column_map()).find(column_obj.find("ref_col").value().get<string>())->second);
+                                
+                                string_length = ref_col_obj_ref->get_str_length();
+                                //var_length needs to be obtained from ref_tab.ref_col
+                                var_length = ref_col_obj_ref->get_is_var_length();
+
+                                if(row_count >= cardinality)
+                                {
+                                    row_count = cardinality;
+                                    table_metadata_obj->set_row_count(row_count);
+                                }
+                                column_metadata_obj = new fk_unique_string_column(*prng, *table_metadata_obj,
+                                        column_name, string_length, var_length, 
+                                        is_random_fk_order(column_obj) ? cardinality : 0, g_prng_seed);
+                            }
+                            else if(constraint == constraints::COMP_PK)
+                            {
+                                if(!is_comp_pk_map_available)
+                                {
+                                    if(column_obj.find("type") != column_obj.end())
+                                        max_combinations = create_nonref_comp_pk_map(column_arr.value(), row_count);
                                     else
                                         max_combinations = create_ref_comp_pk_map(column_arr.value());
                                 }
@@ -1516,194 +4276,2370 @@ namespace redgene
                                         var_length = column_obj.find("var_length").value().get<bool>();
                                 }
 
-                                auto comp_pk_metadata_obj = comp_pk_attrib_map->find(column_name)->second;
-                                column_metadata_obj = new comp_pk_string_column(*prng, *table_metadata_obj, column_name,
-                                    g_prng_seed, row_count, max_combinations, comp_pk_metadata_obj->repeat_window,
-                                    comp_pk_metadata_obj->group_size, string_length, var_length);
-                            }
-                            else if(constraint == constraints::COMP_FK)
-                            {
-                                auto comp_pk_tab_metadata = schema_map.find(column_obj.find("ref_tab").value().get<string>())->second;
-                                auto comp_pk_col_metadata = dynamic_cast<comp_pk_string_column*>(comp_pk_tab_metadata->get_column_map()
-                                    .find(column_obj.find("ref_col").value().get<string>())->second);
+                                auto comp_pk_metadata_obj = comp_pk_attrib_map->find(column_name)->second;
+                                column_metadata_obj = new comp_pk_string_column(*prng, *table_metadata_obj, column_name,
+                                    g_prng_seed, row_count, max_combinations, comp_pk_metadata_obj->repeat_window,
+                                    comp_pk_metadata_obj->group_size, string_length, var_length);
+                            }
+                            else if(constraint == constraints::COMP_FK)
+                            {
+                                auto comp_pk_tab_metadata = schema_map.find(column_obj.find("ref_tab").value().get<string>())->second;
+                                auto comp_pk_col_metadata = dynamic_cast<comp_pk_string_column*>(comp_pk_tab_metadata->get_column_map()
+                                    .find(column_obj.find("ref_col").value().get<string>())->second);
+
+                                column_metadata_obj = new comp_fk_string_column(*prng, *table_metadata_obj, column_name,
+                                    g_prng_seed, comp_pk_tab_metadata->get_row_count(), comp_pk_col_metadata->get_maxvalue(),
+                                    comp_pk_col_metadata->get_repeat_window(), comp_pk_col_metadata->get_group_size(),
+                                    comp_pk_tab_metadata->get_row_count(), skew, comp_pk_col_metadata->get_string_length(),
+                                    comp_pk_col_metadata->get_is_var_length());
+                            }
+                        }
+                        else
+                        {
+                            column_metadata_obj = new normal_string_column(*prng, *table_metadata_obj, 
+                                column_name, cardinality, skew, string_length, var_length);
+                        }
+                    }
+                    else if(column_type == redgene_types::REAL)
+                    {
+                        float real_min = 0.0;
+                        float real_max = 1.0;
+
+                        if(column_obj.find("real_min") != column_obj.end())
+                            real_min = column_obj.find("real_min").value().get<float>();
+                        if(column_obj.find("real_max") != column_obj.end())
+                            real_max = column_obj.find("real_max").value().get<float>();
+
+                        column_metadata_obj = new normal_real_column(*prng, *table_metadata_obj,
+                            column_name, real_min, real_max);
+                    }
+                    else if(column_type == redgene_types::DECIMAL)
+                    {
+                        skewness skew = skewness::NO;
+                        if(column_obj.find("skewness") != column_obj.end())
+                            skew = get_skewness_type(column_obj.find("skewness").value().get<string>());
+                        uint_fast8_t precision = column_obj.value("precision", DECIMAL_MAX_PRECISION);
+                        column_metadata_obj = new decimal_column(*prng, *table_metadata_obj, column_name,
+                            precision, column_obj.value("scale", min<uint_fast8_t>(2, precision)),
+                            column_obj.value("real_min", 0.0), column_obj.value("real_max", 1.0),
+                            column_obj.value("cardinality", 0.0f), skew);
+                    }
+                    else if(column_type == redgene_types::DATE)
+                    {
+                        string ref_user_date = redgene::UNIX_TIME_EPOCH;
+                        uint_fast8_t range_in_years = 10;
+
+                        if(column_obj.find("start_date") != column_obj.end())
+                            ref_user_date = column_obj.find("start_date")
+                                .value().get<string>();
+                        if(column_obj.find("range_in_years") != column_obj.end())
+                            range_in_years = column_obj.find("range_in_years")
+                                .value().get<uint_fast8_t>();
+
+                        column_metadata_obj = new normal_date_column(*prng, *table_metadata_obj,
+                            column_name, ref_user_date, range_in_years);
+                    }
+                    else if(column_type == redgene_types::TIMESTAMP)
+                    {
+                        string ref_user_date = redgene::UNIX_TIME_EPOCH;
+                        uint_fast8_t range_in_years = 10;
+
+                        if(column_obj.find("start_date") != column_obj.end())
+                            ref_user_date = column_obj.find("start_date")
+                                .value().get<string>();
+                        if(column_obj.find("range_in_years") != column_obj.end())
+                            range_in_years = column_obj.find("range_in_years")
+                                .value().get<uint_fast8_t>();
+
+                        if(column_obj.value("order", "random") == "monotonic")
+                            column_metadata_obj = new monotonic_timestamp_column(*table_metadata_obj,
+                                column_name, ref_user_date, range_in_years, get_arrival_process(column_obj),
+                                column_obj.value("peak_hour", 12.0), g_prng_seed);
+                        else
+                            column_metadata_obj = new normal_timestamp_column(*prng, *table_metadata_obj,
+                                column_name, ref_user_date, range_in_years);
+                    }
+
+                    column_metadata_obj->set_stream_id(fnv1a_hash(table_name+"."+column_name));
+                    if(column_obj.find("null_ratio") != column_obj.end())
+                        column_metadata_obj->set_null_ratio(
+                            column_obj.find("null_ratio").value().get<double>(), g_prng_seed);
+                    table_metadata_obj->insert_column_metadata_obj(column_name, column_metadata_obj);
+                }
+                resolve_dependencies(table_metadata_obj);
+                schema_map.insert(pair<string, table*>(table_name, table_metadata_obj));
+                if(comp_pk_attrib_map)
+                {
+                    for(auto col_attrib_item : *comp_pk_attrib_map)
+                    {
+                        arena_delete(col_attrib_item.second);
+                    }
+                    arena_delete(comp_pk_attrib_map);
+                    comp_pk_attrib_map = nullptr;
+                    is_comp_pk_map_available = false;
+                }
+            }
+        }
+
+        //keys of a table, including the rows --append adds to it in this run
+        uint_fast64_t key_space(const string& table_name)
+        {
+            auto append = append_rows.find(table_name);
+            return schema_map.find(table_name)->second->get_row_count() +
+                (append != append_rows.end() ? append->second : 0);
+        }
+
+        void datagen()
+        {
+            json& rgene_json = schema_json;
+            if(rgene_json.find("checkpoint_rows") != rgene_json.end())
+                checkpoint_rows = rgene_json.find("checkpoint_rows").value().get<uint_fast64_t>();
+            output_format = (rgene_json.find("format") != rgene_json.end()) ?
+                rgene_json.find("format").value().get<string>() : "csv";
+            if(output_spec.empty())
+                output_spec = (rgene_json.find("output") != rgene_json.end()) ?
+                    rgene_json.find("output").value().get<string>() : 
+                    (output_format == "pgcopy" ? "%t.pgcopy" : "%t.csv");
+            if(writer_mode.empty())
+                writer_mode = (rgene_json.find("writer") != rgene_json.end()) ?
+                    rgene_json.find("writer").value().get<string>() : "buffered";
+            if(!output_subdirectory.empty())
+                place_in_subdirectory();
+
+            if(output_spec.compare(0, 7, "sqlite:") == 0)
+            {
+#ifdef REDGENE_HAVE_SQLITE
+                load_sqlite(output_spec.substr(7));
+                return;
+#else
+                throw runtime_error("this redgene is built without SQLite, rebuild it with make SQLITE=1!");
+#endif
+            }
+
+            if(!append_rows.empty())
+            {
+                append_tables();
+                return;
+            }
+
+            json checkpoint;
+            vector<string> completed_tables;
+            if(resume)
+                checkpoint = load_checkpoint(completed_tables);
+
+            //iterate over tables
+            for(auto table_obj : schema_map)
+            {
+                if(find(completed_tables.begin(), completed_tables.end(), table_obj.first)
+                    != completed_tables.end())
+                    continue;
+
+                auto table_metadata_obj = table_obj.second;
+                auto column_map = table_metadata_obj->get_column_map();
+                uint_fast64_t start_row = 0;
+                bool resume_table = false;
+                uint_fast64_t resume_offset = 0;
+
+                if(checkpoint.find("table") != checkpoint.end() && 
+                    checkpoint.find("table").value().get<string>() == table_obj.first)
+                {
+                    //the output target drops the partial output written after the last checkpoint
+                    resume_table = true;
+                    start_row = checkpoint.find("rows_completed").value().get<uint_fast64_t>();
+                    resume_offset = checkpoint.find("byte_offset").value().get<uint_fast64_t>();
+
+                    auto column_states = checkpoint.find("column_states").value();
+                    for(auto state = column_states.begin(); state != column_states.end(); ++state)
+                    {
+                        istringstream column_state(state.value().get<string>());
+                        column_map[state.key()]->load_state(column_state);
+                    }
+                }
+
+                output_target target(output_spec, table_obj.first, resume_table, resume_offset,
+                    writer_mode == "direct");
+                //pipes and stdout cannot be resumed, so they are never checkpointed
+                bool checkpointing = checkpoint_rows && target.is_regular_file();
+
+                auto start_time = chrono::steady_clock::now();
+                write_table(table_metadata_obj, target, start_row, table_metadata_obj->get_row_count(),
+                    completed_tables, checkpointing);
+                if(print_stats)
+                    report_stats(table_obj.first, target, table_metadata_obj->get_row_count() - start_row,
+                        target.get_bytes_written() - resume_offset, 
+                        chrono::duration<double>(chrono::steady_clock::now() - start_time).count());
+                completed_tables.push_back(table_obj.first);
+                if(checkpointing)
+                    persist_checkpoint(make_checkpoint(completed_tables, nullptr, 0));
+            }
+            remove(checkpoint_manifest.c_str());
+            write_all_deltas();
+        }
+
+        //output_spec and the checkpoint manifest move into output_subdirectory, which is
+        //created in the directory of the output path (that directory must not depend on %t)
+        void place_in_subdirectory()
+        {
+            if(output_spec == "-" || output_spec.compare(0, 5, "fifo:") == 0)
+                throw runtime_error("output "+output_spec+" cannot be written to "+output_subdirectory+
+                    ", use a file path or sqlite:!");
+            string prefix = output_spec.compare(0, 7, "sqlite:") == 0 ? "sqlite:" : "";
+            string path = output_spec.substr(prefix.size());
+            auto slash = path.rfind('/');
+            string directory = (slash == string::npos) ? "" : path.substr(0, slash + 1);
+            if(directory.find("%t") != string::npos)
+                throw runtime_error("output "+output_spec+" spreads the tables over directories, "
+                    "cannot write them to "+output_subdirectory+"!");
+            directory += output_subdirectory;
+            if(mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST)
+                throw runtime_error("unable to create directory "+directory+": "+strerror(errno));
+            output_spec = prefix + directory + "/" + path.substr(slash == string::npos ? 0 : slash + 1);
+            checkpoint_manifest = directory + "/" + CHECKPOINT_MANIFEST;
+        }
+
+        //--append: the new rows of each table go after the rows already in its file. PK values
+        //continue past the base keys and FK columns of the new rows also reference the rows
+        //appended to their parent. Counter based prngs position every column on the first new
+        //row, so the rows equal those a larger row_count would give; a sequential prng cannot
+        //skip the base rows and is reseeded from (seed, table, row_count) instead, so appends
+        //are repeatable but differ from the rows of a longer base run.
+        void append_tables()
+        {
+            for(auto& append : append_rows)
+            {
+                auto table_itr = schema_map.find(append.first);
+                if(table_itr == schema_map.end())
+                    throw runtime_error("table "+append.first+" is not part of the schema!");
+                table* tab = table_itr->second;
+                uint_fast64_t row_count = tab->get_row_count();
+                check_appendable(append.first, row_count + append.second);
+
+                if(!prng->is_counter_based())
+                {
+                    prng->seed(mix64(g_prng_seed ^ fnv1a_hash64(append.first.data(), append.first.size())) ^
+                        row_count);
+                    for(auto col : tab->get_ordered_columns())
+                        col->seek(row_count);
+                }
+
+                //rows land after the existing ones, a missing file is created
+                uint_fast64_t existing_bytes = 0;
+                bool append_file = false;
+                if(output_spec != "-" && output_spec.compare(0, 5, "fifo:") != 0)
+                {
+                    struct stat file_stat;
+                    string path = output_target::resolve_path(output_spec, append.first);
+                    if(stat(path.c_str(), &file_stat) == 0 && S_ISREG(file_stat.st_mode))
+                    {
+                        append_file = true;
+                        existing_bytes = file_stat.st_size;
+                        //new tuples replace the binary COPY trailer, write_table puts it back
+                        if(output_format == "pgcopy")
+                        {
+                            check_pgcopy_trailer(path, existing_bytes);
+                            existing_bytes -= 2;
+                        }
+                    }
+                }
+                output_target target(output_spec, append.first, append_file, existing_bytes,
+                    writer_mode == "direct");
+
+                auto start_time = chrono::steady_clock::now();
+                write_table(tab, target, row_count, row_count + append.second, vector<string>(), false);
+                if(print_stats)
+                    report_stats(append.first, target, append.second, target.get_bytes_written() - existing_bytes,
+                        chrono::duration<double>(chrono::steady_clock::now() - start_time).count());
+            }
+        }
+
+        static void check_pgcopy_trailer(const string& path, const uint_fast64_t file_bytes)
+        {
+            char trailer[2] = {0, 0};
+            ifstream ifstrm(path, ios::binary);
+            if(file_bytes >= 21)
+                ifstrm.seekg(file_bytes - 2).read(trailer, 2);
+            if(!ifstrm || static_cast<uint8_t>(trailer[0]) != 0xFF || static_cast<uint8_t>(trailer[1]) != 0xFF)
+                throw runtime_error(path+" is not a complete binary COPY file, cannot append to it!");
+        }
+
+        //keys that cannot grow: COMP_PK groups are built for the base row count, and unique
+        //FKs need unused parent keys in order
+        void check_appendable(const string& table_name, const uint_fast64_t total_rows)
+        {
+            for(auto& table_obj : schema_json.find("tables").value())
+            {
+                if(table_obj.find("table_name").value().get<string>() != table_name)
+                    continue;
+                for(auto& column_obj : table_obj.find("columns").value())
+                {
+                    auto constraint = column_obj.find("constraint");
+                    if(constraint == column_obj.end())
+                        continue;
+                    string column_name = column_obj.find("column_name").value().get<string>();
+                    if(constraint.value().get<string>() == "COMP_PK")
+                        throw runtime_error("cannot append to "+table_name+", COMP_PK column "+
+                            column_name+" cannot grow!");
+                    if(constraint.value().get<string>() != "FK_UNIQUE")
+                        continue;
+                    if(is_random_fk_order(column_obj))
+                        throw runtime_error("cannot append to "+table_name+", FK_UNIQUE column "+
+                            column_name+" has a random fk_order!");
+                    string ref_tab = column_obj.find("ref_tab").value().get<string>();
+                    if(total_rows > key_space(ref_tab))
+                        throw runtime_error("cannot append to "+table_name+", FK_UNIQUE column "+
+                            column_name+" needs "+to_string(total_rows)+" keys of "+ref_tab+
+                            " but it has "+to_string(key_space(ref_tab))+"!");
+                }
+            }
+        }
+
+        //"deltas": after the base load, a stream of change events per table, written like
+        //the tables with %t standing for <table>_deltas
+        void write_all_deltas()
+        {
+            auto deltas = schema_json.find("deltas");
+            if(deltas == schema_json.end())
+                return;
+            if(output_spec == "-")
+                throw runtime_error("deltas are written next to their tables, not to stdout!");
+            for(auto& delta_obj : deltas.value())
+            {
+                string table_name = delta_obj.find("table").value().get<string>();
+                output_target target(output_spec, table_name + "_deltas", false, 0, writer_mode == "direct");
+                auto start_time = chrono::steady_clock::now();
+                uint_fast64_t events = write_deltas(schema_map.find(table_name)->second, delta_obj, target);
+                if(print_stats)
+                    report_stats(table_name + "_deltas", target, events, target.get_bytes_written(),
+                        chrono::duration<double>(chrono::steady_clock::now() - start_time).count());
+            }
+        }
+
+        //Writes the change events of a table as rows "op|<columns>", op being I, U or D.
+        //Event e owns row row_count + e: an insert adds that row, so new PK values continue
+        //after the base keys. Updates and deletes pick a live row and keep its key columns
+        //(PK, COMP_PK, FK_UNIQUE and the columns derived from them); an update takes the other
+        //columns from the row the event owns. The op and row of an event are hashed from
+        //(seed, table, e) and live rows are tracked in a live_row_set, so keys stay unique and
+        //a deleted row is never changed again. FK columns draw from the base parent keys,
+        //which the validator keeps from deletes.
+        uint_fast64_t write_deltas(table* tab, const json& delta_obj, output_target& target)
+        {
+            uint_fast64_t events = delta_obj.find("events").value().get<uint_fast64_t>();
+            const json& mix = delta_obj.find("mix").value();
+            double insert_share = mix.value("insert", 0.0);
+            double update_share = mix.value("update", 0.0);
+
+            auto columns = tab->get_ordered_columns();
+            uint_fast64_t row_count = tab->get_row_count();
+            string table_name = tab->get_table_name();
+            vector<bool> is_key(columns.size(), false);
+            for(auto& table_obj : schema_json.find("tables").value())
+            {
+                if(table_obj.find("table_name").value().get<string>() != table_name)
+                    continue;
+                auto& column_arr = table_obj.find("columns").value();
+                for(size_t col = 0; col < column_arr.size(); ++col)
+                {
+                    auto constraint_obj = column_arr[col].find("constraint");
+                    if(constraint_obj == column_arr[col].end())
+                        continue;
+                    constraints constraint = get_redgene_constraint(constraint_obj.value().get<string>());
+                    is_key[col] = constraint == constraints::PK || constraint == constraints::COMP_PK ||
+                        constraint == constraints::FK_UNIQUE;
+                }
+            }
+            for(size_t col = 0; col < columns.size(); ++col)
+                if(columns[col]->is_derived())
+                    is_key[col] = is_key[static_cast<dependent_column*>(columns[col])->get_parent_index()];
+
+            uint_fast64_t key = mix64(g_prng_seed ^ fnv1a_hash64(table_name.data(), table_name.size()));
+            live_row_set live_rows(row_count + events, row_count);
+            row_batch fresh = make_batch(tab), keys = make_batch(tab);
+            vector<delta_ops> ops;
+            vector<uint_fast64_t> key_rows;
+            vector<uint_fast64_t> null_word;
+            string text;
+            uint_fast64_t written = 0;
+            //binary COPY events are tuples with the op as a leading text field
+            bool pgcopy = output_format == "pgcopy";
+            if(pgcopy)
+            {
+                append_pgcopy_header(text);
+                target.write_all(text.data(), text.size());
+            }
+
+            for(uint_fast64_t first = 0; first < events; first += BATCH_ROWS)
+            {
+                uint_fast64_t count = min(BATCH_ROWS, events - first);
+                ops.clear();
+                key_rows.clear();
+                for(uint_fast64_t e = first; e < first + count; ++e)
+                {
+                    uint_fast64_t draw = mix64(key + e * 0x9E3779B97F4A7C15ULL);
+                    double share = (draw >> 11) * (1.0 / 9007199254740992.0);
+                    delta_ops op = (share < insert_share) ? delta_ops::INSERT :
+                        (share < insert_share + update_share) ? delta_ops::UPDATE : delta_ops::DELETE;
+                    //an emptied table only takes inserts, or ends its stream without them
+                    if(op != delta_ops::INSERT && live_rows.size() == 0)
+                    {
+                        if(insert_share == 0)
+                            break;
+                        op = delta_ops::INSERT;
+                    }
+                    uint_fast64_t row = row_count + e;
+                    if(op == delta_ops::INSERT)
+                        live_rows.insert(row);
+                    else
+                    {
+                        row = live_rows.select(mix64(draw) % live_rows.size());
+                        if(op == delta_ops::DELETE)
+                            live_rows.erase(row);
+                    }
+                    ops.push_back(op);
+                    key_rows.push_back(row);
+                }
+                if(ops.empty())
+                    break;
+
+                //the other columns of the rows the events own
+                fill_batch(tab, fresh, row_count + first, ops.size(), is_key);
+
+                //key columns of the rows the events change
+                keys.reset(0);
+                for(size_t col = 0; col < columns.size(); ++col)
+                {
+                    if(!is_key[col] || columns[col]->is_derived())
+                        continue;
+                    for(auto row : key_rows)
+                    {
+                        columns[col]->seek(row);
+                        columns[col]->yield_into(keys.column(col));
+                    }
+                }
+                //the rows are scattered, so derived key columns are derived a row at a time
+                for(size_t col = 0; col < columns.size(); ++col)
+                {
+                    if(!is_key[col] || !columns[col]->is_derived())
+                        continue;
+                    dependent_column* dep_col = static_cast<dependent_column*>(columns[col]);
+                    const column_vector& parent = keys.column(dep_col->get_parent_index());
+                    column_vector parent_value(parent.get_type());
+                    for(size_t i = 0; i < key_rows.size(); ++i)
+                    {
+                        parent_value.clear();
+                        parent_value.append_from(parent, i);
+                        dep_col->derive(parent_value, keys.column(col), key_rows[i], 1);
+                    }
+                }
+
+                text.clear();
+                for(size_t i = 0; i < ops.size(); ++i)
+                {
+                    char op = (ops[i] == delta_ops::INSERT) ? 'I' : (ops[i] == delta_ops::UPDATE) ? 'U' : 'D';
+                    if(pgcopy)
+                    {
+                        append_big_endian(text, columns.size() + 1, 2);
+                        append_pgcopy_text(text, &op, 1);
+                    }
+                    else
+                        text += op;
+                    for(size_t col = 0; col < columns.size(); ++col)
+                    {
+                        if(!pgcopy)
+                            text += '|';
+                        bool is_null = !is_key[col] && ops[i] == delta_ops::DELETE;
+                        if(is_key[col])
+                        {
+                            //null bits are positional, so a key is null as on its own row
+                            auto null_bits = columns[col]->get_null_bits();
+                            if(null_bits)
+                            {
+                                null_bits->fill(null_word, key_rows[i], 1);
+                                is_null = null_word[0] & 1;
+                            }
+                        }
+                        const column_vector& values = is_key[col] ? keys.column(col) : fresh.column(col);
+                        if(pgcopy)
+                            is_null ? append_pgcopy_null(text) : append_pgcopy_value(text, values, i);
+                        else if(!is_null)
+                            append_value_text(text, values, i);
+                    }
+                    if(!pgcopy)
+                        text += '\n';
+                }
+                target.write_all(text.data(), text.size());
+                written += ops.size();
+                if(ops.size() < count)
+                    break;
+            }
+            if(pgcopy)
+            {
+                text.clear();
+                append_pgcopy_trailer(text);
+                target.write_all(text.data(), text.size());
+            }
+            target.finish();
+            return written;
+        }
+
+        //Rows of a table flow through three stages: this thread generates column batches, an
+        //encoder thread formats them and a writer thread writes them out. Stages hand slots
+        //to each other over spsc rings and written slots go back to the generator, so after
+        //warm up no buffer is allocated and a slow disk only stalls once every slot is queued.
+        void write_table(table* tab, output_target& target, const uint_fast64_t start_row,
+            const uint_fast64_t end_row, const vector<string>& completed_tables, const bool checkpointing)
+        {
+            vector<pipeline_slot> slots(PIPELINE_SLOTS);
+            spsc_ring<pipeline_slot*> free_slots(PIPELINE_SLOTS);
+            spsc_ring<pipeline_slot*> to_encode(PIPELINE_SLOTS);
+            spsc_ring<pipeline_slot*> to_write(PIPELINE_SLOTS);
+            for(auto& slot : slots)
+            {
+                slot.batch = make_batch(tab);
+                free_slots.try_push(&slot);
+            }
+
+            //binary COPY: a new file starts with the header, and the trailer follows the last
+            //rows, here when there are none
+            bool pgcopy = output_format == "pgcopy";
+            if(pgcopy)
+            {
+                string framing;
+                if(target.get_bytes_written() == 0)
+                    append_pgcopy_header(framing);
+                if(start_row >= end_row)
+                    append_pgcopy_trailer(framing);
+                if(!framing.empty())
+                    target.write_all(framing.data(), framing.size());
+            }
+
+            exception_ptr stage_error;
+            mutex error_mtx;
+            auto fail = [&](exception_ptr error)
+            {
+                lock_guard<mutex> lock(error_mtx);
+                if(!stage_error)
+                    stage_error = error;
+                free_slots.abort();
+                to_encode.abort();
+                to_write.abort();
+            };
+
+            thread encoder([&]
+            {
+                try
+                {
+                    pipeline_slot* slot;
+                    while(to_encode.pop(slot))
+                    {
+                        slot->text.clear();
+                        if(pgcopy)
+                        {
+                            append_pgcopy_rows(slot->text, slot->batch);
+                            if(slot->last)
+                                append_pgcopy_trailer(slot->text);
+                        }
+                        else
+                            append_csv_rows(slot->text, slot->batch);
+                        if(!to_write.push(slot))
+                            break;
+                    }
+                    to_write.close();
+                }
+                catch(...)
+                {
+                    fail(current_exception());
+                }
+            });
+
+            thread writer([&]
+            {
+                try
+                {
+                    pipeline_slot* slot;
+                    while(to_write.pop(slot))
+                    {
+                        target.write_all(slot->text.data(), slot->text.size());
+                        //the checkpoint of a batch is durable once its rows are written
+                        if(slot->has_checkpoint)
+                        {
+                            target.sync();
+                            slot->checkpoint["byte_offset"] = target.get_bytes_written();
+                            persist_checkpoint(slot->checkpoint);
+                        }
+                        free_slots.push(slot);
+                    }
+                    target.finish();
+                }
+                catch(...)
+                {
+                    fail(current_exception());
+                }
+            });
+
+            try
+            {
+                uint_fast64_t row_count = end_row;
+                pipeline_slot* slot;
+                for(uint_fast64_t i = start_row; i < row_count && free_slots.pop(slot); 
+                    i += BATCH_ROWS)
+                {
+                    fill_batch(tab, slot->batch, i, min(BATCH_ROWS, row_count - i));
+
+                    //checkpoint on the batch that crosses a multiple of checkpoint_rows
+                    uint_fast64_t rows_done = i + slot->batch.size();
+                    slot->last = rows_done >= row_count;
+                    slot->has_checkpoint = checkpointing && rows_done < row_count && 
+                        rows_done / checkpoint_rows != i / checkpoint_rows;
+                    if(slot->has_checkpoint)
+                        slot->checkpoint = make_checkpoint(completed_tables, tab, rows_done);
+
+                    if(!to_encode.push(slot))
+                        break;
+                }
+                to_encode.close();
+            }
+            catch(...)
+            {
+                fail(current_exception());
+            }
+
+            encoder.join();
+            writer.join();
+            if(stage_error)
+                rethrow_exception(stage_error);
+        }
+
+#ifdef REDGENE_HAVE_SQLITE
+        //"sqlite:<path>": every table is created in the database from the schema and bulk
+        //inserted through a prepared statement, SQLITE_COMMIT_ROWS rows per transaction; a
+        //table of the same name is replaced. Tables are generated in the same order as files,
+        //so they hold the same rows, with DATE and TIMESTAMP values in ISO form.
+        void load_sqlite(const string& path)
+        {
+            if(resume)
+                throw runtime_error("sqlite: loads are not checkpointed, rerun them without --resume!");
+            if(schema_json.find("deltas") != schema_json.end())
+                throw runtime_error("deltas are written next to their tables, not into sqlite:!");
+            if(!append_rows.empty())
+                throw runtime_error("--append grows the files of tables, not a sqlite: database!");
+            bool after_load = schema_json.value("sqlite_indexes", string("inline")) == "after_load";
+
+            sqlite_database db(path);
+            //a failed load is thrown away, so rows are not made durable one commit at a time
+            db.exec("PRAGMA journal_mode = MEMORY; PRAGMA synchronous = OFF;");
+            for(auto table_obj : schema_map)
+            {
+                const json* table_json = nullptr;
+                for(auto& tab_json : schema_json.find("tables").value())
+                    if(tab_json.find("table_name").value().get<string>() == table_obj.first)
+                        table_json = &tab_json;
+
+                vector<string> indexes;
+                db.exec("DROP TABLE IF EXISTS " + sqlite_name(table_obj.first) + "; " +
+                    sqlite_create_table(table_obj.second, *table_json, after_load, indexes));
+                auto start_time = chrono::steady_clock::now();
+                load_table(table_obj.second, db);
+                for(auto& index : indexes)
+                    db.exec(index);
+                if(print_stats)
+                {
+                    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+                    uint_fast64_t rows = table_obj.second->get_row_count();
+                    cerr << "stats: " << stats_label(table_obj.first) << ": " << rows << " rows in " << fixed 
+                        << setprecision(2) << seconds << " s (" << setprecision(0) 
+                        << (seconds > 0 ? rows / seconds : 0) << " rows/s), sqlite " << path 
+                        << defaultfloat << endl;
+                }
+            }
+        }
+
+        static string sqlite_name(const string& name)
+        {
+            string quoted = "\"";
+            for(auto chr : name)
+                quoted += (chr == '"') ? string("\"\"") : string(1, chr);
+            return quoted + "\"";
+        }
+
+        static string sqlite_type(column* col)
+        {
+            switch(col->get_type())
+            {
+                case redgene_types::INT: return "INTEGER";
+                case redgene_types::REAL: return "REAL";
+                case redgene_types::STRING: return "TEXT";
+                case redgene_types::DATE: return "DATE";
+                case redgene_types::TIMESTAMP: return "TIMESTAMP";
+                case redgene_types::DECIMAL:
+                {
+                    auto decimal_col = static_cast<decimal_column*>(col);
+                    return "DECIMAL(" + to_string(decimal_col->get_precision()) + ", " + 
+                        to_string(decimal_col->get_scale()) + ")";
+                }
+            }
+            return "TEXT";
+        }
+
+        //CREATE TABLE of a table, with its keys and references. An INT PK is the rowid. With
+        //after_load the other keys are left out and indexes gets the statements building them,
+        //and an index per FK, to run once the rows are in: one sort instead of a b-tree insert
+        //per row.
+        string sqlite_create_table(table* tab, const json& table_obj, const bool after_load,
+            vector<string>& indexes)
+        {
+            string table_name = tab->get_table_name();
+            map<string, const json*> column_objs;
+            for(auto& column_obj : table_obj.find("columns").value())
+                column_objs[column_obj.find("column_name").value().get<string>()] = &column_obj;
+            auto add_index = [&](const string& suffix, const string& columns, const bool unique)
+            {
+                indexes.push_back(string(unique ? "CREATE UNIQUE INDEX " : "CREATE INDEX ") + 
+                    sqlite_name(table_name + "_" + suffix) + " ON " + sqlite_name(table_name) + 
+                    "(" + columns + ")");
+            };
+
+            string ddl = "CREATE TABLE " + sqlite_name(table_name) + "(";
+            string comp_pk;
+            //COMP_FK columns and the parent columns they reference, per parent
+            map<string, pair<string, string>> comp_fks;
+            auto columns = tab->get_ordered_columns();
+            for(size_t i = 0; i < columns.size(); ++i)
+            {
+                string name = columns[i]->column_name();
+                const json& column_obj = *column_objs[name];
+                ddl += (i ? ", " : "") + sqlite_name(name) + " " + sqlite_type(columns[i]);
+
+                auto constraint_obj = column_obj.find("constraint");
+                if(constraint_obj == column_obj.end())
+                    continue;
+                string reference;
+                string ref_tab, ref_col;
+                if(column_obj.find("ref_tab") != column_obj.end())
+                {
+                    ref_tab = column_obj.find("ref_tab").value().get<string>();
+                    ref_col = column_obj.find("ref_col").value().get<string>();
+                    reference = " REFERENCES " + sqlite_name(ref_tab) + "(" + sqlite_name(ref_col) + ")";
+                }
+                switch(get_redgene_constraint(constraint_obj.value().get<string>()))
+                {
+                    case constraints::PK:
+                        if(columns[i]->get_type() == redgene_types::INT || !after_load)
+                            ddl += " PRIMARY KEY";
+                        else
+                            add_index(name + "_pk", sqlite_name(name), true);
+                        break;
+                    case constraints::FK:
+                        ddl += reference;
+                        if(after_load)
+                            add_index(name + "_fk", sqlite_name(name), false);
+                        break;
+                    case constraints::FK_UNIQUE:
+                        if(after_load)
+                            add_index(name + "_fk", sqlite_name(name), true);
+                        else
+                            ddl += " UNIQUE";
+                        ddl += reference;
+                        break;
+                    case constraints::COMP_PK:
+                        comp_pk += (comp_pk.empty() ? "" : ", ") + sqlite_name(name);
+                        ddl += reference;
+                        break;
+                    case constraints::COMP_FK:
+                    {
+                        auto& comp_fk = comp_fks[ref_tab];
+                        comp_fk.first += (comp_fk.first.empty() ? "" : ", ") + sqlite_name(name);
+                        comp_fk.second += (comp_fk.second.empty() ? "" : ", ") + sqlite_name(ref_col);
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+            if(!comp_pk.empty())
+            {
+                if(after_load)
+                    add_index("pk", comp_pk, true);
+                else
+                    ddl += ", PRIMARY KEY(" + comp_pk + ")";
+            }
+            for(auto& comp_fk : comp_fks)
+            {
+                ddl += ", FOREIGN KEY(" + comp_fk.second.first + ") REFERENCES " + 
+                    sqlite_name(comp_fk.first) + "(" + comp_fk.second.second + ")";
+                if(after_load)
+                    add_index(comp_fk.first + "_fk", comp_fk.second.first, false);
+            }
+            return ddl + ")";
+        }
+
+        //Rows of a table go into the database in two stages: a generator thread fills column
+        //batches while this thread, which owns the connection, binds and inserts them.
+        void load_table(table* tab, sqlite_database& db)
+        {
+            size_t column_count = tab->get_ordered_columns().size();
+            string insert_sql = "INSERT INTO " + sqlite_name(tab->get_table_name()) + " VALUES(";
+            for(size_t col = 0; col < column_count; ++col)
+                insert_sql += col ? ", ?" : "?";
+            sqlite_statement insert(db, insert_sql + ")");
+
+            vector<pipeline_slot> slots(PIPELINE_SLOTS);
+            spsc_ring<pipeline_slot*> free_slots(PIPELINE_SLOTS);
+            spsc_ring<pipeline_slot*> to_load(PIPELINE_SLOTS);
+            for(auto& slot : slots)
+            {
+                slot.batch = make_batch(tab);
+                free_slots.try_push(&slot);
+            }
+
+            exception_ptr generate_error;
+            thread generator([&]
+            {
+                try
+                {
+                    uint_fast64_t row_count = tab->get_row_count();
+                    pipeline_slot* slot;
+                    for(uint_fast64_t i = 0; i < row_count && free_slots.pop(slot); i += BATCH_ROWS)
+                    {
+                        fill_batch(tab, slot->batch, i, min(BATCH_ROWS, row_count - i));
+                        if(!to_load.push(slot))
+                            break;
+                    }
+                    to_load.close();
+                }
+                catch(...)
+                {
+                    generate_error = current_exception();
+                    to_load.abort();
+                }
+            });
+
+            try
+            {
+                //DATE, TIMESTAMP and DECIMAL text of the row being inserted, per column
+                vector<string> texts(column_count);
+                uint_fast64_t uncommitted = 0;
+                db.exec("BEGIN");
+                pipeline_slot* slot;
+                while(to_load.pop(slot))
+                {
+                    insert_batch(insert, slot->batch, texts);
+                    uncommitted += slot->batch.size();
+                    if(uncommitted >= SQLITE_COMMIT_ROWS)
+                    {
+                        db.exec("COMMIT; BEGIN");
+                        uncommitted = 0;
+                    }
+                    free_slots.push(slot);
+                }
+            }
+            catch(...)
+            {
+                free_slots.abort();
+                to_load.abort();
+                generator.join();
+                throw;
+            }
+            generator.join();
+            if(generate_error)
+                rethrow_exception(generate_error);
+            db.exec("COMMIT");
+        }
+
+        static void insert_batch(sqlite_statement& insert, const row_batch& batch, vector<string>& texts)
+        {
+            for(uint_fast64_t row = 0; row < batch.size(); ++row)
+            {
+                for(size_t col = 0; col < batch.column_count(); ++col)
+                {
+                    const column_vector& values = batch.column(col);
+                    int idx = static_cast<int>(col) + 1;
+                    if(values.is_null(row))
+                    {
+                        insert.bind_null(idx);
+                        continue;
+                    }
+                    string& text = texts[col];
+                    switch(values.get_type())
+                    {
+                        case redgene_types::INT:
+                            insert.bind_int(idx, static_cast<int_fast64_t>(values.get_ints()[row]));
+                            break;
+                        case redgene_types::REAL:
+                            insert.bind_real(idx, values.get_reals()[row]);
+                            break;
+                        case redgene_types::STRING:
+                        {
+                            str_view view = values.get_str(row);
+                            insert.bind_text(idx, view.data, view.size);
+                            break;
+                        }
+                        case redgene_types::DATE:
+                        case redgene_types::TIMESTAMP:
+                            text.clear();
+                            append_iso_date_string(text, values.get_times()[row], 
+                                values.get_type() == redgene_types::TIMESTAMP);
+                            insert.bind_text(idx, text.data(), text.size());
+                            break;
+                        case redgene_types::DECIMAL:
+                            text.clear();
+                            append_decimal_string(text, values.get_decimals()[row], values.get_scale());
+                            insert.bind_text(idx, text.data(), text.size());
+                            break;
+                    }
+                }
+                insert.step();
+            }
+        }
+#endif
+
+        //tables of engines running side by side are told apart by their subdirectory
+        string stats_label(const string& table_name) const
+        {
+            return output_subdirectory.empty() ? table_name : output_subdirectory + "/" + table_name;
+        }
+
+        void report_stats(const string& table_name, const output_target& target, 
+            const uint_fast64_t rows, const uint_fast64_t bytes, const double seconds)
+        {
+            double mbytes = bytes / 1e6;
+            cerr << "stats: " << stats_label(table_name) << ": " << rows << " rows, " << fixed << setprecision(1)
+                << mbytes << " MB in " << setprecision(2) << seconds << " s (" << setprecision(1)
+                << (seconds > 0 ? mbytes / seconds : 0) << " MB/s), writer " << target.writer_name();
+            double residency = target.is_regular_file() ? page_cache_residency(target.get_path()) : -1;
+            if(residency >= 0)
+                cerr << ", " << residency * 100 << "% of the file in page cache";
+            cerr << defaultfloat << endl;
+        }
+
+        row_batch make_batch(table* tab)
+        {
+            row_batch batch;
+            for(auto col : tab->get_ordered_columns())
+            {
+                batch.add_column(col->column_name(), col->get_type());
+                if(col->get_type() == redgene_types::DECIMAL)
+                {
+                    auto decimal_col = static_cast<decimal_column*>(col);
+                    batch.column(batch.column_count() - 1).set_decimal(decimal_col->get_precision(),
+                        decimal_col->get_scale());
+                }
+            }
+            return batch;
+        }
+
+        //generates rows [start_row, start_row + rows) of a table into the batch; columns
+        //flagged in skipped are left empty
+        void fill_batch(table* tab, row_batch& batch, const uint_fast64_t start_row, 
+            const uint_fast64_t rows, const vector<bool>& skipped = vector<bool>())
+        {
+            bool counter_mode = prng->is_counter_based();
+            auto columns = tab->get_ordered_columns();
+            vector<size_t> generated, derived;
+            for(size_t col = 0; col < columns.size(); ++col)
+                if(skipped.empty() || !skipped[col])
+                    (columns[col]->is_derived() ? derived : generated).push_back(col);
+
+            batch.reset(start_row);
+            //counter based prngs give every column its own stream, positioned by row, so
+            //columns fill a batch one at a time; otherwise the columns share the prng and
+            //take their turn row by row
+            if(counter_mode)
+                for(size_t col : generated)
+                    columns[col]->yield_batch(batch.column(col), start_row, rows);
+            else
+                for(uint_fast64_t i = start_row; i < start_row + rows; ++i)
+                    for(size_t col : generated)
+                        columns[col]->yield_into(batch.column(col));
+
+            //dependent columns are derived from their parent's whole vector at once
+            for(size_t col : derived)
+            {
+                dependent_column* dep_col = static_cast<dependent_column*>(columns[col]);
+                dep_col->derive(batch.column(dep_col->get_parent_index()), batch.column(col), 
+                    start_row, rows);
+            }
+            batch.set_size(rows);
+
+            //whole words of null bits per column, no per cell draw
+            for(size_t col = 0; col < columns.size(); ++col)
+                if(columns[col]->get_null_bits() && (skipped.empty() || !skipped[col]))
+                    batch.column(col).set_nulls(*columns[col]->get_null_bits(), start_row, rows);
+        }
+
+        json load_checkpoint(vector<string>& completed_tables)
+        {
+            json checkpoint;
+            ifstream manifest(checkpoint_manifest);
+            if(!manifest.is_open())
+            {
+                cerr << "No checkpoint manifest found, generating from the beginning." << endl;
+                return checkpoint;
+            }
+            manifest >> checkpoint;
+
+            if(checkpoint.find("seed").value().get<uint_fast64_t>() != g_prng_seed)
+                throw runtime_error("checkpoint manifest belongs to a run with a different seed!");
+            if(checkpoint.find("scale_factor") != checkpoint.end() && 
+                checkpoint.find("scale_factor").value().get<double>() != scale_factor)
+                throw runtime_error("checkpoint manifest belongs to a run with a different scale factor!");
+
+            completed_tables = checkpoint.find("tables_completed").value().get<vector<string>>();
+            istringstream prng_state(checkpoint.find("prng_state").value().get<string>());
+            prng->load_state(prng_state);
+            return checkpoint;
+        }
+
+        //manifest records the tables already written, the row position reached in the current
+        //table and the prng/column state needed to continue from that position. The byte
+        //offset of that row is added by the writer once the rows before it are written.
+        json make_checkpoint(const vector<string>& completed_tables, table* active_table,
+            const uint_fast64_t rows_completed)
+        {
+            json checkpoint;
+            checkpoint["seed"] = g_prng_seed;
+            checkpoint["scale_factor"] = scale_factor;
+            checkpoint["tables_completed"] = completed_tables;
+
+            ostringstream prng_state;
+            prng->save_state(prng_state);
+            checkpoint["prng_state"] = prng_state.str();
+
+            if(active_table)
+            {
+                checkpoint["table"] = active_table->get_table_name();
+                checkpoint["rows_completed"] = rows_completed;
+
+                json column_states;
+                for(auto column : active_table->get_column_map())
+                {
+                    ostringstream column_state;
+                    column.second->save_state(column_state);
+                    column_states[column.first] = column_state.str();
+                }
+                checkpoint["column_states"] = column_states;
+            }
+            return checkpoint;
+        }
+
+        void persist_checkpoint(const json& checkpoint)
+        {
+            //write and rename, so that a crash never leaves a torn manifest behind
+            string tmp_manifest = checkpoint_manifest + ".tmp";
+            ofstream manifest(tmp_manifest, std::ofstream::trunc);
+            manifest << checkpoint;
+            manifest.close();
+            if(rename(tmp_manifest.c_str(), checkpoint_manifest.c_str()) != 0)
+                throw runtime_error("unable to write checkpoint manifest!");
+        }
+
+        skewness get_skewness_type(const string& skew_string)
+        {
+            skewness skew;
+            if(skew_string == "NO")
+                skew = skewness::NO;
+            else if(skew_string == "LOW")
+                skew = skewness::LOW;
+            else if(skew_string == "MEDIUM")
+                skew = skewness::MEDIUM;
+            else if(skew_string == "HIGH")
+                skew = skewness::HIGH;
+            else if(skew_string == "EXTREME")
+                skew = skewness::EXTREME;
+            
+            return skew;
+        }
+
+        redgene_types get_redgene_type(const string& type_string)
+        {
+            redgene_types type;
+            if(type_string == "INT")
+                type = redgene_types::INT;
+            else if(type_string == "REAL")
+                type = redgene_types::REAL;
+            else if(type_string == "STRING")
+                type = redgene_types::STRING;
+            else if(type_string == "DATE")
+                type = redgene_types::DATE;
+            else if(type_string == "TIMESTAMP")
+                type = redgene_types::TIMESTAMP;
+            else if(type_string == "DECIMAL")
+                type = redgene_types::DECIMAL;
+            
+            return type;
+        }
+
+        constraints get_redgene_constraint(const string& constraint_string)
+        {
+            constraints constraint;
+            if(constraint_string == "PK")
+                constraint = constraints::PK;
+            else if(constraint_string == "FK")
+                constraint = constraints::FK;
+            else if(constraint_string == "FK_UNIQUE")
+                constraint = constraints::FK_UNIQUE;
+            else if(constraint_string == "COMP_PK")
+                constraint = constraints::COMP_PK;
+            else if(constraint_string == "COMP_FK")
+                constraint = constraints::COMP_FK;
+            
+            return constraint;
+        }
+    };
+
+
+    //Pull based reader over the rows of one table. Each next() fills the reader's batch with
+    //the following rows; str_views taken from the batch stay valid until the next call.
+    //With a sequential prng the tables share one random stream, so reading them in the order
+    //generate() writes them (by table name) gives the same values as the csv files, with a
+    //counter based prng any table can be read in any order and any number of times.
+    class batch_reader
+    {
+    private:
+        redgene_engine& engine;
+        table* tab;
+        uint_fast64_t batch_rows;
+        uint_fast64_t next_row = 0;
+        row_batch current;
+    public:
+        class iterator
+        {
+        private:
+            batch_reader* reader;
+        public:
+            iterator(batch_reader* reader) : reader(reader)
+            {
+
+            }
+
+            const row_batch& operator*() const
+            {
+                return reader->current;
+            }
+
+            const row_batch* operator->() const
+            {
+                return &reader->current;
+            }
+
+            iterator& operator++()
+            {
+                if(!reader->next())
+                    reader = nullptr;
+                return *this;
+            }
+
+            bool operator!=(const iterator& other) const
+            {
+                return reader != other.reader;
+            }
+        };
+
+        batch_reader(redgene_engine& engine, table* tab, const uint_fast64_t batch_rows) :
+            engine(engine), tab(tab), batch_rows(batch_rows), current(engine.make_batch(tab))
+        {
+
+        }
+
+        bool next()
+        {
+            if(next_row >= tab->get_row_count())
+                return false;
+            engine.fill_batch(tab, current, next_row, 
+                min(batch_rows, tab->get_row_count() - next_row));
+            next_row += current.size();
+            return true;
+        }
+
+        const row_batch& batch() const
+        {
+            return current;
+        }
+
+        uint_fast64_t get_row_count() const
+        {
+            return tab->get_row_count();
+        }
+
+        iterator begin()
+        {
+            return next() ? iterator(this) : iterator(nullptr);
+        }
+
+        iterator end()
+        {
+            return iterator(nullptr);
+        }
+    };
+
+    inline batch_reader redgene_engine::open_table(const string& table_name, const uint_fast64_t batch_rows)
+    {
+        if(batch_rows == 0)
+            throw runtime_error("batches of "+table_name+" need at least one row!");
+        prepare();
+        auto table_itr = schema_map.find(table_name);
+        if(table_itr == schema_map.end())
+            throw runtime_error("table "+table_name+" is not part of the schema!");
+        return batch_reader(*this, table_itr->second, batch_rows);
+    }
+
+    //REDGENE ENSEMBLE CLASS
+    //Generates a schema once per seed of a range in a single process, for variance studies.
+    //Validation, plan loading and schema resolution are done once, by the setup engine; each
+    //seed builds its columns in an engine of its own that writes to the seed_<seed>
+    //subdirectory of the output, one engine per hardware thread at a time.
+    class redgene_ensemble
+    {
+    private:
+        redgene_engine& setup;
+        uint_fast64_t first_seed;
+        uint_fast64_t seed_count;
+        unsigned int jobs;
+    public:
+        redgene_ensemble(redgene_engine& setup, const uint_fast64_t first_seed,
+            const uint_fast64_t last_seed) : setup(setup), first_seed(first_seed)
+        {
+            if(first_seed > last_seed)
+                throw runtime_error("seed range "+to_string(first_seed)+".."+to_string(last_seed)+
+                    " is empty!");
+            seed_count = last_seed - first_seed + 1;
+            if(seed_count == 0)
+                throw runtime_error("seed range is too large!");
+            jobs = static_cast<unsigned int>(min<uint_fast64_t>(seed_count,
+                max(1u, thread::hardware_concurrency())));
+            setup.get_schema();
+        }
+
+        static string seed_directory(const uint_fast64_t seed)
+        {
+            return "seed_" + to_string(seed);
+        }
+
+        //a seed that fails does not stop the others, returns whether every seed was generated
+        bool generate(ostream& out, const bool resume = false)
+        {
+            atomic<uint_fast64_t> next_seed(0);
+            mutex out_mtx;
+            bool all_generated = true;
+            auto worker = [&]
+            {
+                for(uint_fast64_t idx; (idx = next_seed++) < seed_count; )
+                {
+                    uint_fast64_t seed = first_seed + idx;
+                    string error;
+                    try
+                    {
+                        redgene_engine seed_engine(setup, seed);
+                        seed_engine.set_output_subdirectory(seed_directory(seed));
+                        seed_engine.generate(resume);
+                    }
+                    catch(const std::exception& e)
+                    {
+                        error = e.what();
+                    }
+                    lock_guard<mutex> lock(out_mtx);
+                    if(error.empty())
+                        out << seed_directory(seed) << ": generated" << endl;
+                    else
+                    {
+                        all_generated = false;
+                        cerr << seed_directory(seed) << ": " << error << endl;
+                    }
+                }
+            };
+
+            vector<thread> workers;
+            for(unsigned int i = 1; i < jobs; ++i)
+                workers.emplace_back(worker);
+            worker();
+            for(auto& worker_thread : workers)
+                worker_thread.join();
+            return all_generated;
+        }
+    };
+
+    //REDGENE PLANNER CLASS
+    //Estimates what generating a schema costs without generating it: output bytes from the
+    //text width of every column, memory held by string warehouses and set distribution
+    //vectors, and runtime projected from a calibration run on a shrunk copy of the schema.
+    class redgene_planner
+    {
+    private:
+        typedef struct column_estimate
+        {
+            string column_name;
+            double text_bytes = 0;
+            //held until the engine is destroyed
+            double memory_bytes = 0;
+            //held only while the column is constructed
+            double transient_bytes = 0;
+            string memory_note;
+        } column_estimate;
+
+        typedef struct table_estimate
+        {
+            string table_name;
+            uint_fast64_t rows = 0;
+            double bytes = 0;
+            double memory_bytes = 0;
+            double transient_bytes = 0;
+            double seconds = -1;
+            vector<column_estimate> columns;
+        } table_estimate;
+
+        //approximate heap footprint of std::map<uint64, string> and std::set<uint64> nodes
+        static const size_t MAP_NODE_BYTES = 80;
+        static const size_t SET_NODE_BYTES = 48;
+
+        redgene_engine& engine;
+        const json& schema;
+        double memory_budget_mb = 0;
+        //output bytes of binary COPY rather than text
+        bool pgcopy = false;
+
+        const json& find_table(const string& table_name) const
+        {
+            for(auto& table_obj : schema.find("tables").value())
+                if(table_obj.find("table_name").value().get<string>() == table_name)
+                    return table_obj;
+            throw runtime_error("table "+table_name+" is not part of the schema!");
+        }
+
+        const json& find_column(const json& table_obj, const string& column_name) const
+        {
+            for(auto& column_obj : table_obj.find("columns").value())
+                if(column_obj.find("column_name").value().get<string>() == column_name)
+                    return column_obj;
+            throw runtime_error("column "+column_name+" is not part of the schema!");
+        }
+
+        static uint_fast64_t row_count(const json& table_obj)
+        {
+            return table_obj.find("row_count").value().get<uint_fast64_t>();
+        }
+
+        static string get_string(const json& json_node, const string& key, const string& default_value)
+        {
+            return (json_node.find(key) != json_node.end()) ? 
+                json_node.find(key).value().get<string>() : default_value;
+        }
+
+        //column that defines type and length, following ref_tab/ref_col
+        const json& defining_column(const json& column_obj) const
+        {
+            if(column_obj.find("type") != column_obj.end() || column_obj.find("ref_tab") == column_obj.end())
+                return column_obj;
+            return defining_column(find_column(find_table(column_obj.find("ref_tab").value().get<string>()),
+                column_obj.find("ref_col").value().get<string>()));
+        }
+
+        //average decimal width of the integers 1..max_value
+        static double average_digits(const uint_fast64_t max_value)
+        {
+            if(max_value <= 1)
+                return 1;
+            double total = 0;
+            uint_fast64_t low = 1;
+            for(unsigned int digits = 1; low <= max_value; ++digits)
+            {
+                uint_fast64_t high = (low > max_value / 10) ? max_value : min(max_value, low * 10 - 1);
+                total += static_cast<double>(high - low + 1) * digits;
+                if(high == max_value)
+                    break;
+                low *= 10;
+            }
+            return total / max_value;
+        }
+
+        static double average_length(const json& column_obj)
+        {
+            double length = (column_obj.find("length") != column_obj.end()) ?
+                column_obj.find("length").value().get<double>() : 10;
+            bool var_length = (column_obj.find("var_length") != column_obj.end()) &&
+                column_obj.find("var_length").value().get<bool>();
+            //variable lengths are uniform from 6 up to length
+            return (var_length && length > 6) ? (6 + length) / 2 : length;
+        }
+
+        //%g keeps 6 significant digits: "0.xxxxxx" below 1, 7 characters up to 1e6, exponents above
+        static double real_width(const json& column_obj)
+        {
+            double real_min = (column_obj.find("real_min") != column_obj.end()) ?
+                column_obj.find("real_min").value().get<double>() : 0;
+            double real_max = (column_obj.find("real_max") != column_obj.end()) ?
+                column_obj.find("real_max").value().get<double>() : 1;
+            double magnitude = max(fabs(real_min), fabs(real_max));
+            double width = (magnitude >= 1e6) ? 11 : ((magnitude >= 1) ? 7 : 8);
+            return width + ((real_min < 0) ? 0.5 : 0);
+        }
+
+        //digits of the larger bound, the point and the sign of the negative half
+        static double decimal_width(const json& column_obj)
+        {
+            double real_min = column_obj.value("real_min", 0.0);
+            double real_max = column_obj.value("real_max", 1.0);
+            uint_fast64_t scale = column_obj.value("scale", 2);
+            double magnitude = max(fabs(real_min), fabs(real_max));
+            double width = max(1.0, floor(log10(max(1.0, magnitude))) + 1) + (scale ? scale + 1 : 0);
+            return width + ((real_min < 0) ? 0.5 : 0);
+        }
+
+        static void add_warehouse(column_estimate& estimate, const double entries, const double length)
+        {
+            //strings beyond the small string buffer get their own heap block
+            double entry_bytes = MAP_NODE_BYTES + ((length > 15) ? ceil((length + 1) / 16) * 16 + 16 : 0);
+            estimate.memory_bytes += entries * entry_bytes;
+            ostringstream note;
+            note << "string warehouse of up to " << static_cast<uint_fast64_t>(entries) << " entries";
+            estimate.memory_note = note.str();
+        }
+
+        static void add_set_distribution(column_estimate& estimate, const double amount, const bool kept)
+        {
+            estimate.transient_bytes += amount * (sizeof(uint_fast64_t) + SET_NODE_BYTES);
+            if(kept)
+                estimate.memory_bytes += amount * sizeof(uint_fast64_t);
+            ostringstream note;
+            note << "set distribution over " << static_cast<uint_fast64_t>(amount) << " values";
+            estimate.memory_note = note.str();
+        }
+
+        //distinct values of a COMP_PK column: 1..alpha without references, else the ref rows
+        double comp_pk_domain(const json& table_obj, const json& column_obj) const
+        {
+            if(column_obj.find("ref_tab") != column_obj.end())
+                return row_count(find_table(column_obj.find("ref_tab").value().get<string>()));
+            size_t comp_pk_columns = 0;
+            for(auto& col : table_obj.find("columns").value())
+                if(get_string(col, "constraint", "") == "COMP_PK")
+                    ++comp_pk_columns;
+            return ceil(pow(4 * row_count(table_obj), 1.0 / comp_pk_columns));
+        }
+
+        column_estimate estimate_column(const json& table_obj, const json& column_obj) const
+        {
+            column_estimate estimate;
+            estimate.column_name = column_obj.find("column_name").value().get<string>();
+            const json& type_obj = defining_column(column_obj);
+            string type = get_string(type_obj, "type", "INT");
+            string constraint = get_string(column_obj, "constraint", "");
+            double rows = row_count(table_obj);
+            bool is_string = (type == "STRING");
+            double length = is_string ? average_length(type_obj) : 0;
+
+            //distinct values the column draws from
+            double domain = rows;
+            if(constraint == "FK" || constraint == "FK_UNIQUE")
+                domain = row_count(find_table(column_obj.find("ref_tab").value().get<string>()));
+            else if(constraint == "COMP_PK")
+                domain = comp_pk_domain(table_obj, column_obj);
+            else if(constraint == "COMP_FK")
+            {
+                const json& pk_table = find_table(column_obj.find("ref_tab").value().get<string>());
+                domain = comp_pk_domain(pk_table, find_column(pk_table, 
+                    column_obj.find("ref_col").value().get<string>()));
+            }
+            else if(constraint.empty() && column_obj.find("cardinality") != column_obj.end())
+            {
+                double cardinality = column_obj.find("cardinality").value().get<double>();
+                domain = (cardinality <= 1) ? max(1.0, floor(rows * cardinality)) : cardinality;
+            }
+            else if(column_obj.find("profile") != column_obj.end() && 
+                column_obj.find("profile").value().find("histogram") != column_obj.find("profile").value().end())
+                domain = column_obj.find("profile").value().find("histogram").value().back().get<double>();
+
+            if(is_string)
+                estimate.text_bytes = length;
+            else if(type == "INT")
+                estimate.text_bytes = average_digits(static_cast<uint_fast64_t>(domain));
+            else if(type == "REAL")
+                estimate.text_bytes = real_width(type_obj);
+            else if(type == "DECIMAL")
+                estimate.text_bytes = decimal_width(type_obj);
+            else if(type == "DATE")
+                estimate.text_bytes = 11;
+            else
+                estimate.text_bytes = 20;
+            //binary COPY values: 8 byte INT, REAL and TIMESTAMP, 4 byte DATE, DECIMAL digits
+            //in pairs of bytes per 4 after an 8 byte header
+            if(pgcopy)
+                estimate.text_bytes = is_string ? length : (type == "DATE") ? 4 : 
+                    (type == "DECIMAL") ? 8 + 2 * ceil(decimal_width(type_obj) / 4) : 8;
+            //nulls are empty fields
+            if(column_obj.find("null_ratio") != column_obj.end())
+                estimate.text_bytes *= 1 - column_obj.find("null_ratio").value().get<double>();
+            //'|' or the newline, or the length of a binary COPY field
+            estimate.text_bytes += pgcopy ? 4 : 1;
+
+            double distinct = min(rows, domain);
+            if(constraint == "COMP_PK")
+            {
+                add_set_distribution(estimate, rows, true);
+                if(is_string && type_obj.find("var_length") != type_obj.end() && 
+                    type_obj.find("var_length").value().get<bool>())
+                    add_warehouse(estimate, distinct, length);
+            }
+            else if(constraint == "COMP_FK")
+            {
+                double pk_rows = row_count(find_table(column_obj.find("ref_tab").value().get<string>()));
+                add_set_distribution(estimate, pk_rows, true);
+                if(is_string)
+                    add_warehouse(estimate, distinct, length);
+            }
+            else if(is_string && constraint == "FK")
+                add_warehouse(estimate, distinct, length);
+            else if(is_string && column_obj.find("profile") != column_obj.end())
+            {
+                auto& profile = column_obj.find("profile").value();
+                double ndv = (profile.find("ndv") != profile.end()) ? profile.find("ndv").value().get<double>() : 0;
+                if(ndv < 0.7 * rows)
+                    add_warehouse(estimate, min(rows, ndv), length);
+            }
+            else if(is_string && constraint.empty() && column_obj.find("depends_on") == column_obj.end())
+            {
+                double cardinality = (column_obj.find("cardinality") != column_obj.end()) ?
+                    column_obj.find("cardinality").value().get<double>() : 1;
+                bool skewed = get_string(column_obj, "skewness", "NO") != "NO";
+                bool var_length = type_obj.find("var_length") != type_obj.end() && 
+                    type_obj.find("var_length").value().get<bool>();
+                if(cardinality < 0.7 || cardinality > 1 || (var_length && skewed))
+                    add_warehouse(estimate, distinct, length);
+            }
+            return estimate;
+        }
+
+        //runtime of each table projected from generating a proportionally shrunk copy of the
+        //schema in memory; seconds per row at the small size are assumed to hold at full size.
+        void calibrate(vector<table_estimate>& tables, double& setup_seconds, double& fraction)
+        {
+            uint_fast64_t largest = 1;
+            for(auto& estimate : tables)
+                largest = max(largest, estimate.rows);
+            fraction = min(1.0, static_cast<double>(PLAN_CALIBRATION_ROWS) / largest);
+
+            json calibration_schema = schema;
+            calibration_schema.erase("scale_factor");
+            for(auto& table_obj : calibration_schema.find("tables").value())
+                table_obj.find("row_count").value() = max<uint_fast64_t>(1, 
+                    llround(row_count(table_obj) * fraction));
+
+            redgene_validator calibration_validator(calibration_schema);
+            redgene_engine calibration_engine(calibration_validator);
+            auto start_time = chrono::steady_clock::now();
+            calibration_engine.open_table(tables.front().table_name);
+            setup_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count()
+                / fraction;
+
+            string text;
+            for(auto& estimate : tables)
+            {
+                auto reader = calibration_engine.open_table(estimate.table_name);
+                start_time = chrono::steady_clock::now();
+                for(auto& batch : reader)
+                {
+                    text.clear();
+                    if(pgcopy)
+                        append_pgcopy_rows(text, batch);
+                    else
+                        append_csv_rows(text, batch);
+                }
+                double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+                estimate.seconds = seconds / reader.get_row_count() * estimate.rows;
+            }
+        }
+
+        static double to_mb(const double bytes)
+        {
+            return bytes / 1e6;
+        }
+    public:
+        redgene_planner(redgene_engine& engine) : engine(engine), schema(engine.get_schema())
+        {
+            pgcopy = get_string(schema, "format", "csv") == "pgcopy";
+            if(schema.find("memory_budget_mb") != schema.end())
+                memory_budget_mb = schema.find("memory_budget_mb").value().get<double>();
+        }
+
+        //overrides the "memory_budget_mb" of the schema
+        void set_memory_budget(const double memory_budget_mb)
+        {
+            if(memory_budget_mb <= 0)
+                throw runtime_error("memory budget must be greater than 0!");
+            this->memory_budget_mb = memory_budget_mb;
+        }
+
+        void report(ostream& out)
+        {
+            vector<table_estimate> tables;
+            for(auto& table_obj : schema.find("tables").value())
+            {
+                table_estimate estimate;
+                estimate.table_name = table_obj.find("table_name").value().get<string>();
+                estimate.rows = row_count(table_obj);
+                //FK_UNIQUE tables are cut down to the rows of the referenced table
+                for(auto& column_obj : table_obj.find("columns").value())
+                    if(get_string(column_obj, "constraint", "") == "FK_UNIQUE")
+                        estimate.rows = min(estimate.rows, row_count(find_table(
+                            column_obj.find("ref_tab").value().get<string>())));
+
+                //the field count of a binary COPY tuple
+                double row_bytes = pgcopy ? 2 : 0;
+                for(auto& column_obj : table_obj.find("columns").value())
+                {
+                    column_estimate column = estimate_column(table_obj, column_obj);
+                    row_bytes += column.text_bytes;
+                    estimate.memory_bytes += column.memory_bytes;
+                    estimate.transient_bytes = max(estimate.transient_bytes, column.transient_bytes);
+                    estimate.columns.push_back(column);
+                }
+                estimate.bytes = row_bytes * estimate.rows;
+                //batches and their text in flight in the write pipeline
+                estimate.transient_bytes = max(estimate.transient_bytes, 
+                    2.0 * PIPELINE_SLOTS * min<uint_fast64_t>(BATCH_ROWS, estimate.rows) * row_bytes);
+                tables.push_back(estimate);
+            }
+            //generation visits tables in name order
+            sort(tables.begin(), tables.end(), [](const table_estimate& a, const table_estimate& b)
+                { return a.table_name < b.table_name; });
+
+            double setup_seconds = -1, fraction = 0;
+            string calibration_error;
+            try
+            {
+                calibrate(tables, setup_seconds, fraction);
+            }
+            catch(const std::exception& e)
+            {
+                calibration_error = e.what();
+                setup_seconds = -1;
+                for(auto& estimate : tables)
+                    estimate.seconds = -1;
+            }
 
-                                column_metadata_obj = new comp_fk_string_column(*prng, *table_metadata_obj, column_name,
-                                    g_prng_seed, comp_pk_tab_metadata->get_row_count(), comp_pk_col_metadata->get_maxvalue(),
-                                    comp_pk_col_metadata->get_repeat_window(), comp_pk_col_metadata->get_group_size(),
-                                    comp_pk_tab_metadata->get_row_count(), skew, comp_pk_col_metadata->get_string_length(),
-                                    comp_pk_col_metadata->get_is_var_length());
-                            }
-                        }
-                        else
-                        {
-                            column_metadata_obj = new normal_string_column(*prng, *table_metadata_obj, 
-                                column_name, cardinality, skew, string_length, var_length);
-                        }
-                    }
-                    else if(column_type == redgene_types::REAL)
-                    {
-                        float real_min = 0.0;
-                        float real_max = 1.0;
+            uint_fast64_t total_rows = 0;
+            double total_bytes = 0, total_memory = 0, peak_transient = 0, total_seconds = setup_seconds;
+            out << fixed << setprecision(1);
+            out << "plan at scale factor " << engine.get_scale_factor() << endl;
+            for(auto& estimate : tables)
+            {
+                total_rows += estimate.rows;
+                total_bytes += estimate.bytes;
+                total_memory += estimate.memory_bytes;
+                peak_transient = max(peak_transient, estimate.transient_bytes);
+                total_seconds += estimate.seconds;
+
+                out << estimate.table_name << ": " << estimate.rows << " rows, " << to_mb(estimate.bytes)
+                    << " MB output, " << to_mb(estimate.memory_bytes) << " MB held, " 
+                    << to_mb(estimate.transient_bytes) << " MB transient";
+                if(estimate.seconds >= 0)
+                    out << ", ~" << setprecision(2) << estimate.seconds << " s" << setprecision(1);
+                out << endl;
+                for(auto& column : estimate.columns)
+                    if(!column.memory_note.empty())
+                        out << "    " << column.column_name << ": " << column.memory_note << ", "
+                            << to_mb(max(column.memory_bytes, column.transient_bytes)) << " MB" << endl;
+            }
 
-                        if(column_obj.find("real_min") != column_obj.end())
-                            real_min = column_obj.find("real_min").value().get<float>();
-                        if(column_obj.find("real_max") != column_obj.end())
-                            real_max = column_obj.find("real_max").value().get<float>();
+            //every table's columns live for the whole run, transients come one at a time
+            double peak_memory = total_memory + peak_transient;
+            out << "total: " << total_rows << " rows, " << to_mb(total_bytes) << " MB output, "
+                << to_mb(peak_memory) << " MB peak memory";
+            if(calibration_error.empty())
+                out << ", ~" << setprecision(2) << total_seconds << " s (setup ~" << setup_seconds
+                    << " s, calibrated on " << setprecision(3) << fraction * 100 << "% of the rows)";
+            else
+                out << ", runtime unknown (calibration failed: " << calibration_error << ")";
+            out << endl;
 
-                        column_metadata_obj = new normal_real_column(*prng, *table_metadata_obj,
-                            column_name, real_min, real_max);
-                    }
-                    else if(column_type == redgene_types::DATE)
+            if(memory_budget_mb > 0)
+            {
+                for(auto& estimate : tables)
+                    for(auto& column : estimate.columns)
                     {
-                        string ref_user_date = redgene::UNIX_TIME_EPOCH;
-                        uint_fast8_t range_in_years = 10;
+                        double column_mb = to_mb(max(column.memory_bytes, column.transient_bytes));
+                        if(column_mb > memory_budget_mb)
+                            out << "WARNING: " << estimate.table_name << "." << column.column_name
+                                << " needs ~" << setprecision(1) << column_mb << " MB (" << column.memory_note
+                                << "), over the memory budget of " << memory_budget_mb << " MB" << endl;
+                    }
+                if(to_mb(peak_memory) > memory_budget_mb)
+                    out << "WARNING: peak memory of ~" << setprecision(1) << to_mb(peak_memory) 
+                        << " MB is over the memory budget of " << memory_budget_mb << " MB" << endl;
+            }
+            out << defaultfloat;
+        }
+    };
 
-                        if(column_obj.find("start_date") != column_obj.end())
-                            ref_user_date = column_obj.find("start_date")
-                                .value().get<string>();
-                        if(column_obj.find("range_in_years") != column_obj.end())
-                            range_in_years = column_obj.find("range_in_years")
-                                .value().get<uint_fast8_t>();
+    //Profiles the columns of a delimited file in one streaming pass, in memory independent of
+    //its size: HyperLogLog for the ndv, Space-Saving for the most common values and a reservoir
+    //sample for the equi-depth histogram. report() writes a schema template whose columns
+    //carry the profiles, to generate data shaped like the file.
+    class redgene_profiler
+    {
+    private:
+        typedef struct column_stats
+        {
+            hyperloglog ndv_sketch;
+            space_saving mcv_sketch = space_saving(4 * PROFILE_MCV_LIMIT);
+            reservoir_sample<double> numbers;
+            bool is_int = true;
+            bool is_real = true;
+            //DD-MON-YYYY and DD-MON-YYYY HH:MM:SS, as redgene writes DATE and TIMESTAMP
+            bool is_date = true;
+            bool is_timestamp = true;
+            bool is_ascending = true;
+            int_fast64_t min_time = numeric_limits<int_fast64_t>::max();
+            int_fast64_t max_time = numeric_limits<int_fast64_t>::min();
+            int_fast64_t last_time = numeric_limits<int_fast64_t>::min();
+            string min_field;
+            uint_fast64_t nulls = 0;
+            size_t min_length = numeric_limits<size_t>::max();
+            size_t max_length = 0;
+        } column_stats;
+
+        string table_name;
+        char delimiter;
+        uint_fast64_t rows = 0;
+        vector<column_stats> stats;
+
+        //seconds since 1970-01-01 of the wall clock a DD-MON-YYYY[ HH:MM:SS] field shows,
+        //-1 when the field is not one
+        static int_fast64_t parse_date_field(const string& field, const bool with_time)
+        {
+            if(field.size() != (with_time ? 20u : 11u) || field[2] != '-' || field[6] != '-' ||
+                (with_time && (field[11] != ' ' || field[14] != ':' || field[17] != ':')))
+                return -1;
+            auto number = [&](const size_t pos, const size_t width)
+            {
+                int_fast64_t value = 0;
+                for(size_t i = pos; i < pos + width; ++i)
+                {
+                    if(!isdigit(field[i]))
+                        return static_cast<int_fast64_t>(-1);
+                    value = value * 10 + (field[i] - '0');
+                }
+                return value;
+            };
+            unsigned int month = 0;
+            while(month < 12 && field.compare(3, 3, MONTH_NAMES[month]) != 0)
+                ++month;
+            int_fast64_t day = number(0, 2), year = number(7, 4);
+            if(month == 12 || day < 1 || day > 31 || year < 0)
+                return -1;
+            int_fast64_t seconds = days_from_civil(year, month + 1, day) * 86400;
+            if(with_time)
+            {
+                int_fast64_t hour = number(12, 2), minute = number(15, 2), second = number(18, 2);
+                if(hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60)
+                    return -1;
+                seconds += hour * 3600 + minute * 60 + second;
+            }
+            return seconds;
+        }
 
-                        column_metadata_obj = new normal_date_column(*prng, *table_metadata_obj,
-                            column_name, ref_user_date, range_in_years);
-                    }
-                    else if(column_type == redgene_types::TIMESTAMP)
+        void add_field(column_stats& column, const string& field)
+        {
+            if(field.empty())
+            {
+                ++column.nulls;
+                return;
+            }
+            column.ndv_sketch.add(field.data(), field.size());
+            column.mcv_sketch.add(field);
+            column.min_length = min(column.min_length, field.size());
+            column.max_length = max(column.max_length, field.size());
+
+            if(column.is_int)
+                column.is_int = field.size() <= 19 && 
+                    all_of(field.begin(), field.end(), [](char c) { return isdigit(c); });
+            if(column.is_real)
+            {
+                char* end;
+                double value = strtod(field.c_str(), &end);
+                column.is_real = (end == field.c_str() + field.size()) && isfinite(value);
+                if(column.is_real)
+                    column.numbers.add(value);
+            }
+            if(column.is_date || column.is_timestamp)
+            {
+                column.is_date = column.is_date && field.size() == 11;
+                column.is_timestamp = column.is_timestamp && field.size() == 20;
+                int_fast64_t time = parse_date_field(field, column.is_timestamp);
+                if(time < 0)
+                    column.is_date = column.is_timestamp = false;
+                else
+                {
+                    if(time < column.min_time)
                     {
-                        string ref_user_date = redgene::UNIX_TIME_EPOCH;
-                        uint_fast8_t range_in_years = 10;
+                        column.min_time = time;
+                        column.min_field = field;
+                    }
+                    column.max_time = max(column.max_time, time);
+                    column.is_ascending = column.is_ascending && time >= column.last_time;
+                    column.last_time = time;
+                }
+            }
+        }
 
-                        if(column_obj.find("start_date") != column_obj.end())
-                            ref_user_date = column_obj.find("start_date")
-                                .value().get<string>();
-                        if(column_obj.find("range_in_years") != column_obj.end())
-                            range_in_years = column_obj.find("range_in_years")
-                                .value().get<uint_fast8_t>();
+        json profile_column(const column_stats& column, const size_t index) const
+        {
+            json column_obj;
+            column_obj["column_name"] = "c" + to_string(index + 1);
+            string type = column.is_int ? "INT" : (column.is_real ? "REAL" : 
+                (column.is_timestamp ? "TIMESTAMP" : (column.is_date ? "DATE" : "STRING")));
+            column_obj["type"] = type;
+            uint_fast64_t values = rows - column.nulls;
+            if(column.nulls > 0)
+                column_obj["null_ratio"] = static_cast<double>(column.nulls) / rows;
+            if(values == 0)
+            {
+                //nothing but nulls
+                column_obj["type"] = "INT";
+                column_obj["cardinality"] = 1;
+                return column_obj;
+            }
+            if(type == "DATE" || type == "TIMESTAMP")
+            {
+                //no profile for times: the observed range, in whole years from the earliest
+                //value, and time order
+                const string& first = column.min_field;
+                column_obj["start_date"] = first.substr(7, 4) + "-" + first.substr(3, 3) + "-" + 
+                    first.substr(0, 2) + (type == "TIMESTAMP" ? first.substr(11) : " 00:00:00");
+                column_obj["range_in_years"] = max<int_fast64_t>(1, min<int_fast64_t>(255,
+                    (column.max_time - column.min_time + 31535999) / 31536000));
+                if(type == "TIMESTAMP" && column.is_ascending && values > 1)
+                    column_obj["order"] = "monotonic";
+                return column_obj;
+            }
+            if(type == "STRING")
+            {
+                column_obj["length"] = max<size_t>(1, min<size_t>(column.max_length, 4000));
+                if(column.min_length != column.max_length)
+                    column_obj["var_length"] = true;
+            }
 
-                        column_metadata_obj = new normal_timestamp_column(*prng, *table_metadata_obj,
-                            column_name, ref_user_date, range_in_years);
-                    }
+            json profile = json::object();
+            auto tracked = column.mcv_sketch.top();
+            uint_fast64_t ndv = column.mcv_sketch.is_exact() ? tracked.size() :
+                max<uint_fast64_t>(tracked.size(), llround(column.ndv_sketch.estimate()));
+            ndv = max<uint_fast64_t>(1, min(ndv, values));
+
+            //a few distinct values are all listed, otherwise the values that are common
+            //beyond doubt, measured by their guaranteed count; a count inherited mostly from
+            //evictions says nothing about the value. Frequencies are the guaranteed counts,
+            //exact when nothing was evicted.
+            bool list_all = column.mcv_sketch.is_exact() && tracked.size() <= PROFILE_MCV_LIMIT;
+            json mcv = json::array();
+            set<string> mcv_values;
+            double mcv_total = 0;
+            for(auto& counter : tracked)
+            {
+                uint_fast64_t guaranteed = counter.count - counter.error;
+                if(mcv.size() == PROFILE_MCV_LIMIT)
+                    break;
+                if(!list_all && (guaranteed < 2 || counter.error >= guaranteed ||
+                    guaranteed <= 1.25 * values / ndv))
+                    continue;
+                json mcv_obj;
+                if(type == "INT")
+                    mcv_obj["value"] = stoull(counter.value);
+                else if(type == "REAL")
+                    mcv_obj["value"] = stod(counter.value);
+                else
+                    mcv_obj["value"] = counter.value;
+                mcv_obj["freq"] = static_cast<double>(guaranteed) / values;
+                mcv_total += static_cast<double>(guaranteed) / values;
+                mcv_values.insert(counter.value);
+                mcv.push_back(mcv_obj);
+            }
 
-                    table_metadata_obj->insert_column_metadata_obj(column_name, column_metadata_obj);
+            //equi-depth bounds over the sampled values that are not mcvs
+            vector<double> rest;
+            if(type != "STRING")
+            {
+                set<double> mcv_numbers;
+                for(auto& value : mcv_values)
+                    mcv_numbers.insert(stod(value));
+                for(double value : column.numbers.get_sample())
+                    if(mcv_numbers.find(value) == mcv_numbers.end())
+                        rest.push_back(value);
+                sort(rest.begin(), rest.end());
+            }
+            bool has_rest = (type == "STRING") ? ndv > mcv.size() : !rest.empty();
+            if(!has_rest || mcv_total > 1)
+            {
+                //the mcvs are all there is
+                for(auto& mcv_obj : mcv)
+                    mcv_obj["freq"] = mcv_obj["freq"].get<double>() / mcv_total;
+            }
+            else if(mcv_total > 1 - 1e-6)
+                has_rest = false;
+
+            if(!mcv.empty())
+                profile["mcv"] = mcv;
+            if(has_rest && type != "STRING")
+            {
+                size_t buckets = min(PROFILE_HISTOGRAM_BUCKETS, rest.size());
+                json histogram = json::array();
+                for(size_t b = 0; b <= buckets; ++b)
+                {
+                    double bound = rest[min(rest.size() - 1, b * (rest.size() - 1) / max<size_t>(1, buckets))];
+                    if(type == "INT")
+                        histogram.push_back(static_cast<uint_fast64_t>(llround(bound)));
+                    else
+                        histogram.push_back(bound);
                 }
-                schema_map.insert(pair<string, table*>(table_name, table_metadata_obj));
-                if(comp_pk_attrib_map)
+                if(histogram.size() == 1)
+                    histogram.push_back(histogram.front());
+                profile["histogram"] = histogram;
+            }
+            profile["ndv"] = ndv;
+            column_obj["profile"] = profile;
+            return column_obj;
+        }
+    public:
+        redgene_profiler(const string& csv_path, const string& table_name = "", 
+            const char delimiter = '|') : table_name(table_name), delimiter(delimiter)
+        {
+            ifstream csv(csv_path);
+            if(!csv.is_open())
+                throw runtime_error("unable to open " + csv_path + " for profiling!");
+            if(this->table_name.empty())
+            {
+                //file name without directory and extension
+                string name = csv_path.substr(csv_path.find_last_of('/') + 1);
+                this->table_name = name.substr(0, name.find('.'));
+            }
+
+            string line, field;
+            while(getline(csv, line))
+            {
+                ++rows;
+                size_t column = 0, start = 0;
+                while(true)
                 {
-                    for(auto col_attrib_item : *comp_pk_attrib_map)
+                    size_t end = line.find(delimiter, start);
+                    if(stats.size() <= column)
                     {
-                        delete col_attrib_item.second;
+                        if(rows > 1)
+                            throw runtime_error(csv_path + ": line " + to_string(rows) + " has more fields than the first line!");
+                        stats.emplace_back();
                     }
-                    delete comp_pk_attrib_map;
-                    comp_pk_attrib_map = nullptr;
-                    is_comp_pk_map_available = false;
+                    field.assign(line, start, (end == string::npos ? line.size() : end) - start);
+                    add_field(stats[column++], field);
+                    if(end == string::npos)
+                        break;
+                    start = end + 1;
                 }
+                if(column != stats.size())
+                    throw runtime_error(csv_path + ": line " + to_string(rows) + " has fewer fields than the first line!");
             }
+            if(rows == 0)
+                throw runtime_error(csv_path + " has no rows to profile!");
         }
 
-        void datagen()
+        uint_fast64_t get_row_count() const
         {
-            //iterate over tables
-            for(auto table_obj : schema_map)
+            return rows;
+        }
+
+        //schema template with one table holding the profiled columns
+        void report(ostream& out) const
+        {
+            json table_obj;
+            table_obj["table_name"] = table_name;
+            table_obj["row_count"] = rows;
+            table_obj["columns"] = json::array();
+            for(size_t i = 0; i < stats.size(); ++i)
+                table_obj["columns"].push_back(profile_column(stats[i], i));
+
+            json schema;
+            schema["tables"] = json::array({table_obj});
+            out << schema.dump(4) << endl;
+        }
+    };
+
+    //Checks generated output against its schema in one streaming pass over every table, in
+    //memory bounded by the sketches rather than by the data: row counts, the ndv of every
+    //column (HyperLogLog) against its configured cardinality, the zipf exponent fitted to
+    //the most common values (Space-Saving) of skewed columns, uniqueness of PK, FK_UNIQUE
+    //and COMP_PK values and FK/COMP_FK references into the parent keys (Bloom filters).
+    //A Bloom filter never misses a key it holds, so every reported missing reference is
+    //real; duplicates are reported beyond the false positives the filter explains.
+    class redgene_verifier
+    {
+    private:
+        typedef struct column_check
+        {
+            string column_name;
+            string constraint;
+            hyperloglog ndv_sketch;
+            space_saving top_values;
+            //distinct values configured, at most or exactly
+            double expected_ndv = 0;
+            bool ndv_is_exact = false;
+            double alpha = 0;
+            bloom_filter* unique_keys = nullptr;
+            const bloom_filter* parent_keys = nullptr;
+            string parent_name;
+            uint_fast64_t repeats = 0;
+            double expected_repeats = 0;
+            uint_fast64_t missing = 0;
+            uint_fast64_t nulls = 0;
+        } column_check;
+
+        const json& schema;
+        string output_spec;
+        //keys of the referenced PK columns and COMP_PK tuples, by "table.column" or "table"
+        map<string, bloom_filter*> key_sets;
+        bool all_passed = true;
+
+        const json& find_table(const string& table_name) const
+        {
+            for(auto& table_obj : schema.find("tables").value())
+                if(table_obj.find("table_name").value().get<string>() == table_name)
+                    return table_obj;
+            throw runtime_error("unknown table "+table_name+"!");
+        }
+
+        static string get_string(const json& json_node, const string& key)
+        {
+            auto itr = json_node.find(key);
+            return (itr == json_node.end()) ? "" : itr.value().get<string>();
+        }
+
+        bool is_referenced(const string& key_name) const
+        {
+            for(auto& table_obj : schema.find("tables").value())
+                for(auto& column_obj : table_obj.find("columns").value())
+                {
+                    string ref_tab = get_string(column_obj, "ref_tab");
+                    if(ref_tab.empty())
+                        continue;
+                    if(key_name == ref_tab || key_name == ref_tab + "." + get_string(column_obj, "ref_col"))
+                        return true;
+                }
+            return false;
+        }
+
+        //tables after the tables they reference
+        void order_tables(const json& table_obj, set<string>& visited, vector<const json*>& order) const
+        {
+            string table_name = table_obj.find("table_name").value().get<string>();
+            if(!visited.insert(table_name).second)
+                return;
+            for(auto& column_obj : table_obj.find("columns").value())
             {
-                ofstream flatfile(table_obj.first+".csv", std::ofstream::trunc);
+                string ref_tab = get_string(column_obj, "ref_tab");
+                if(!ref_tab.empty() && ref_tab != table_name)
+                    order_tables(find_table(ref_tab), visited, order);
+            }
+            order.push_back(&table_obj);
+        }
 
-                auto table_metadata_obj = table_obj.second;
-                auto column_map = table_metadata_obj->get_column_map();
-                auto column_order = table_metadata_obj->get_column_order();
+        uint_fast64_t expected_rows(const json& table_obj) const
+        {
+            uint_fast64_t rows = table_obj.find("row_count").value().get<uint_fast64_t>();
+            for(auto& column_obj : table_obj.find("columns").value())
+                if(get_string(column_obj, "constraint") == "FK_UNIQUE")
+                    rows = min(rows, find_table(get_string(column_obj, "ref_tab"))
+                        .find("row_count").value().get<uint_fast64_t>());
+            return rows;
+        }
+
+        static double skew_alpha(const string& skew)
+        {
+            if(skew == "LOW")
+                return get_alpha_value(skewness::LOW);
+            if(skew == "MEDIUM")
+                return get_alpha_value(skewness::MEDIUM);
+            if(skew == "HIGH")
+                return get_alpha_value(skewness::HIGH);
+            if(skew == "EXTREME")
+                return get_alpha_value(skewness::EXTREME);
+            return 0;
+        }
+
+        void prepare_check(column_check& check, const json& table_obj, const json& column_obj,
+            const uint_fast64_t rows)
+        {
+            string table_name = table_obj.find("table_name").value().get<string>();
+            check.column_name = column_obj.find("column_name").value().get<string>();
+            check.constraint = get_string(column_obj, "constraint");
+            check.alpha = skew_alpha(get_string(column_obj, "skewness"));
+
+            if(check.constraint == "PK" || check.constraint == "FK_UNIQUE")
+            {
+                check.expected_ndv = rows;
+                check.ndv_is_exact = true;
+                check.unique_keys = new bloom_filter(rows, VERIFY_BLOOM_BITS);
+            }
+            if(check.constraint == "FK" || check.constraint == "FK_UNIQUE")
+            {
+                check.parent_name = get_string(column_obj, "ref_tab") + "." + get_string(column_obj, "ref_col");
+                const json& parent = find_table(get_string(column_obj, "ref_tab"));
+                if(check.constraint == "FK")
+                    check.expected_ndv = parent.find("row_count").value().get<uint_fast64_t>();
+                //keys of the same table are still being read
+                auto key_set = key_sets.find(check.parent_name);
+                if(key_set != key_sets.end() && get_string(column_obj, "ref_tab") != table_name)
+                    check.parent_keys = key_set->second;
+            }
+            else if(column_obj.find("cardinality") != column_obj.end() && check.constraint.empty())
+            {
+                double cardinality = column_obj.find("cardinality").value().get<double>();
+                check.expected_ndv = (cardinality < 1) ? floor(rows * cardinality) :
+                    (cardinality == 1 ? rows : cardinality);
+                //sequential columns hold every value once
+                check.ndv_is_exact = (cardinality == 1 && column_obj.find("depends_on") == column_obj.end());
+            }
+            else if(column_obj.find("profile") != column_obj.end() && 
+                column_obj.find("profile").value().find("ndv") != column_obj.find("profile").value().end())
+                check.expected_ndv = column_obj.find("profile").value().find("ndv").value().get<double>();
+
+            if(check.constraint == "PK" && is_referenced(table_name + "." + check.column_name))
+                key_sets[table_name + "." + check.column_name] = check.unique_keys;
+        }
+
+        //least squares slope of log(count) over log(rank) on the reliably counted top values
+        static double fit_alpha(const space_saving& top_values)
+        {
+            auto counters = top_values.top();
+            double sx = 0, sy = 0, sxx = 0, sxy = 0;
+            size_t n = 0;
+            for(size_t rank = 1; rank <= counters.size(); ++rank)
+            {
+                uint_fast64_t guaranteed = counters[rank - 1].count - counters[rank - 1].error;
+                if(guaranteed < 10)
+                    break;
+                double x = log(static_cast<double>(rank)), y = log(static_cast<double>(guaranteed));
+                sx += x; sy += y; sxx += x * x; sxy += x * y;
+                ++n;
+            }
+            if(n < 3)
+                return -1;
+            return -(n * sxy - sx * sy) / (n * sxx - sx * sx);
+        }
+
+        //repeats the filter's false positives explain, about three standard deviations over
+        //their expected (Poisson) count; with a sparse filter a single repeat is already too many
+        static bool too_many_repeats(const uint_fast64_t repeats, const double expected)
+        {
+            return repeats > floor(expected + 3 * sqrt(expected));
+        }
+
+        void fail(ostream& out, const string& what)
+        {
+            out << "    FAIL: " << what << endl;
+            all_passed = false;
+        }
+
+        void report_column(ostream& out, const column_check& check, const uint_fast64_t rows)
+        {
+            double ndv = check.ndv_sketch.estimate();
+            out << "  " << check.column_name;
+            if(!check.constraint.empty())
+                out << " " << check.constraint;
+            out << ": ndv ~" << llround(ndv);
+            if(check.expected_ndv > 0)
+                out << " (configured " << (check.ndv_is_exact ? "" : "up to ") << llround(check.expected_ndv) << ")";
+            if(check.nulls > 0)
+                out << ", " << setprecision(3) << 100.0 * check.nulls / max<uint_fast64_t>(1, rows) << "% null";
+            double fitted = (check.alpha > 0) ? fit_alpha(check.top_values) : -1;
+            if(fitted >= 0)
+                out << ", zipf alpha ~" << setprecision(2) << fitted << " (configured " << check.alpha << ")";
+            out << setprecision(6) << endl;
+
+            //sketch error is about 1%, keep clear of it
+            if(check.expected_ndv > 0 && ndv > check.expected_ndv * 1.03 + 2)
+                fail(out, "more distinct values than configured");
+            if(check.ndv_is_exact && ndv < check.expected_ndv * 0.97 - 2 && !check.unique_keys)
+                fail(out, "fewer distinct values than configured");
+            if(check.unique_keys && check.repeats > 0)
+                out << "    " << check.repeats << " keys repeated (~" << setprecision(2) << check.expected_repeats 
+                    << " false positives expected)" << setprecision(6) << endl;
+            if(check.unique_keys && too_many_repeats(check.repeats, check.expected_repeats))
+                fail(out, "repeated keys beyond the filter's false positives");
+            if(check.missing > 0)
+                fail(out, to_string(check.missing) + " values missing from " + check.parent_name);
+            if(!check.parent_name.empty() && !check.parent_keys)
+                out << "    references into " << check.parent_name << " not checked" << endl;
+            if(fitted >= 0 && abs(fitted - check.alpha) > 0.2)
+                out << "    WARNING: skew differs from the configured zipf exponent" << endl;
+        }
+
+        void verify_table(ostream& out, const json& table_obj)
+        {
+            string table_name = table_obj.find("table_name").value().get<string>();
+            string path = output_target::resolve_path(output_spec, table_name);
+            ifstream data(path);
+            if(!data.is_open())
+            {
+                out << table_name << ": " << path << " not found" << endl;
+                all_passed = false;
+                return;
+            }
+
+            uint_fast64_t rows = expected_rows(table_obj);
+            auto& column_arr = table_obj.find("columns").value();
+            vector<column_check> checks(column_arr.size());
+            for(size_t i = 0; i < column_arr.size(); ++i)
+                prepare_check(checks[i], table_obj, column_arr[i], rows);
+
+            //composite keys are checked as tuples, COMP_FK fields in the parent's COMP_PK order
+            vector<size_t> comp_pk_fields, comp_fk_fields;
+            bloom_filter* comp_pk_keys = nullptr;
+            const bloom_filter* comp_parent_keys = nullptr;
+            string comp_parent;
+            uint_fast64_t comp_repeats = 0, comp_missing = 0;
+            double comp_expected_repeats = 0;
+            for(size_t i = 0; i < column_arr.size(); ++i)
+            {
+                if(checks[i].constraint == "COMP_PK")
+                    comp_pk_fields.push_back(i);
+                else if(checks[i].constraint == "COMP_FK")
+                    comp_parent = get_string(column_arr[i], "ref_tab");
+            }
+            if(!comp_pk_fields.empty())
+            {
+                comp_pk_keys = new bloom_filter(rows, VERIFY_BLOOM_BITS);
+                if(is_referenced(table_name))
+                    key_sets[table_name] = comp_pk_keys;
+            }
+            if(!comp_parent.empty())
+            {
+                for(auto& parent_column : find_table(comp_parent).find("columns").value())
+                    if(get_string(parent_column, "constraint") == "COMP_PK")
+                        for(size_t i = 0; i < column_arr.size(); ++i)
+                            if(checks[i].constraint == "COMP_FK" && get_string(column_arr[i], "ref_col") ==
+                                parent_column.find("column_name").value().get<string>())
+                                comp_fk_fields.push_back(i);
+                auto key_set = key_sets.find(comp_parent);
+                if(key_set != key_sets.end())
+                    comp_parent_keys = key_set->second;
+            }
 
-                for(uint_fast64_t i = 0; i < table_metadata_obj->get_row_count(); ++i)
+            string line, field;
+            vector<uint_fast64_t> hashes(column_arr.size());
+            uint_fast64_t actual_rows = 0, bad_lines = 0;
+            while(getline(data, line))
+            {
+                ++actual_rows;
+                size_t column = 0, start = 0;
+                while(column < checks.size())
                 {
-                    for(auto itr = column_order.begin(); itr != column_order.end(); ++itr)
+                    size_t end = line.find('|', start);
+                    field.assign(line, start, (end == string::npos ? line.size() : end) - start);
+                    column_check& check = checks[column];
+                    hashes[column] = mix64(fnv1a_hash64(field.data(), field.size()));
+                    if(field.empty())
+                        ++check.nulls;
+                    else
                     {
-                        if(column_map[*itr]->get_type() == redgene_types::INT)
+                        check.ndv_sketch.add_hash(hashes[column]);
+                        if(check.alpha > 0)
+                            check.top_values.add(field);
+                        if(check.unique_keys)
                         {
-                            if(column_map[*itr]->get_constraint_type() == constraints::COMP_PK)
-                                flatfile << dynamic_cast<comp_pk_int_column*>(column_map[*itr])->yield();
-                            else if(column_map[*itr]->get_constraint_type() == constraints::COMP_FK)
-                                flatfile << dynamic_cast<comp_fk_int_column*>(column_map[*itr])->yield();
-                            else
-                                flatfile << dynamic_cast<normal_int_column*>(column_map[*itr])->yield();
+                            check.expected_repeats += check.unique_keys->false_positive_rate();
+                            check.repeats += check.unique_keys->add(hashes[column]);
                         }
-                        else if(column_map[*itr]->get_type() == redgene_types::STRING)
-                        {
-                            if(column_map[*itr]->get_constraint_type() == constraints::COMP_PK)
-                                flatfile << dynamic_cast<comp_pk_string_column*>(column_map[*itr])->yield();
-                            else if(column_map[*itr]->get_constraint_type() == constraints::COMP_FK)
-                                flatfile << dynamic_cast<comp_fk_string_column*>(column_map[*itr])->yield();
-                            else
-                                flatfile << dynamic_cast<normal_string_column*>(column_map[*itr])->yield();
-                        }
-                        else if(column_map[*itr]->get_type() == redgene_types::REAL)
-                            flatfile << dynamic_cast<normal_real_column*>(column_map[*itr])->yield();
-                        else if(column_map[*itr]->get_type() ==  redgene_types::DATE)
-                            flatfile << dynamic_cast<normal_date_column*>(column_map[*itr])->yield();
-                        else if(column_map[*itr]->get_type() ==  redgene_types::TIMESTAMP)
-                            flatfile << dynamic_cast<normal_timestamp_column*>(column_map[*itr])->yield();
-                        
-                        if(column_order.end() - itr != 1)
-                            flatfile << '|';
+                        if(check.parent_keys && !check.parent_keys->contains(hashes[column]))
+                            ++check.missing;
                     }
-                    flatfile << '\n';
+                    ++column;
+                    if(end == string::npos)
+                        break;
+                    start = end + 1;
+                }
+                if(column != checks.size())
+                {
+                    ++bad_lines;
+                    continue;
+                }
+                if(comp_pk_keys)
+                {
+                    uint_fast64_t tuple = 0;
+                    for(size_t i : comp_pk_fields)
+                        tuple = mix64(tuple ^ hashes[i]);
+                    comp_expected_repeats += comp_pk_keys->false_positive_rate();
+                    comp_repeats += comp_pk_keys->add(tuple);
+                }
+                if(comp_parent_keys)
+                {
+                    uint_fast64_t tuple = 0;
+                    for(size_t i : comp_fk_fields)
+                        tuple = mix64(tuple ^ hashes[i]);
+                    comp_missing += !comp_parent_keys->contains(tuple);
                 }
+            }
 
-                if(flatfile.is_open())
+            out << table_name << ": " << actual_rows << " rows (configured " << rows << ") in " << path << endl;
+            if(actual_rows != rows)
+                fail(out, "row count differs from the configuration");
+            if(bad_lines > 0)
+                fail(out, to_string(bad_lines) + " lines with fewer fields than columns");
+            for(auto& check : checks)
+                report_column(out, check, actual_rows);
+            if(comp_pk_keys)
+            {
+                out << "  COMP_PK tuples: " << comp_repeats << " repeated (~" << setprecision(2) << comp_expected_repeats
+                    << " false positives expected)" << setprecision(6) << endl;
+                if(too_many_repeats(comp_repeats, comp_expected_repeats))
+                    fail(out, "repeated COMP_PK tuples beyond the filter's false positives");
+            }
+            if(!comp_parent.empty())
+            {
+                if(comp_parent_keys)
                 {
-                    flatfile.flush();
-                    flatfile.close();
+                    out << "  COMP_FK tuples: " << comp_missing << " missing from " << comp_parent << endl;
+                    if(comp_missing > 0)
+                        fail(out, "COMP_FK tuples missing from the parent's COMP_PK");
                 }
+                else
+                    out << "  COMP_FK references into " << comp_parent << " not checked" << endl;
             }
-        }
 
-        skewness get_skewness_type(const string& skew_string)
+            //filters no later table references go now
+            for(auto& check : checks)
+                if(key_sets.find(table_name + "." + check.column_name) == key_sets.end())
+                    delete check.unique_keys;
+            if(comp_pk_keys && key_sets.find(table_name) == key_sets.end())
+                delete comp_pk_keys;
+        }
+    public:
+        //output_spec is where the tables were written, as for generation; empty takes the
+        //schema's "output" or the default
+        redgene_verifier(redgene_engine& engine, const string& output_spec = "") :
+            schema(engine.get_schema()), output_spec(output_spec)
         {
-            skewness skew;
-            if(skew_string == "NO")
-                skew = skewness::NO;
-            else if(skew_string == "LOW")
-                skew = skewness::LOW;
-            else if(skew_string == "MEDIUM")
-                skew = skewness::MEDIUM;
-            else if(skew_string == "HIGH")
-                skew = skewness::HIGH;
-            else if(skew_string == "EXTREME")
-                skew = skewness::EXTREME;
-            
-            return skew;
+            if(this->output_spec.empty())
+                this->output_spec = (schema.find("output") != schema.end()) ?
+                    schema.find("output").value().get<string>() : "%t.csv";
+            if(this->output_spec == "-" || this->output_spec.compare(0, 5, "fifo:") == 0 ||
+                this->output_spec.compare(0, 7, "sqlite:") == 0)
+                throw runtime_error("only output written to files can be verified!");
+            if(schema.value("format", string("csv")) != "csv")
+                throw runtime_error("only csv output can be verified!");
         }
 
-        redgene_types get_redgene_type(const string& type_string)
+        ~redgene_verifier()
         {
-            redgene_types type;
-            if(type_string == "INT")
-                type = redgene_types::INT;
-            else if(type_string == "REAL")
-                type = redgene_types::REAL;
-            else if(type_string == "STRING")
-                type = redgene_types::STRING;
-            else if(type_string == "DATE")
-                type = redgene_types::DATE;
-            else if(type_string == "TIMESTAMP")
-                type = redgene_types::TIMESTAMP;
-            
-            return type;
+            for(auto& key_set : key_sets)
+                delete key_set.second;
         }
 
-        constraints get_redgene_constraint(const string& constraint_string)
+        //reports every table and returns whether all checks passed
+        bool report(ostream& out)
         {
-            constraints constraint;
-            if(constraint_string == "PK")
-                constraint = constraints::PK;
-            else if(constraint_string == "FK")
-                constraint = constraints::FK;
-            else if(constraint_string == "FK_UNIQUE")
-                constraint = constraints::FK_UNIQUE;
-            else if(constraint_string == "COMP_PK")
-                constraint = constraints::COMP_PK;
-            else if(constraint_string == "COMP_FK")
-                constraint = constraints::COMP_FK;
-            
-            return constraint;
+            set<string> visited;
+            vector<const json*> order;
+            for(auto& table_obj : schema.find("tables").value())
+                order_tables(table_obj, visited, order);
+            for(auto table_obj : order)
+                verify_table(out, *table_obj);
+            out << (all_passed ? "verification passed" : "verification FAILED") << endl;
+            return all_passed;
         }
     };
-
-}
\ No newline at end of file
+}
@@ -0,0 +1,179 @@
+#include "rglibinc.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+//Per table memory arenas for the generation state of columns: prng engines, distributions,
+//string generators and their buffers. Needs to be included before rand_engine.hpp,
+//prob_dist.hpp and rg_utils.hpp, which allocate through it.
+namespace redgene
+{
+    //objects of a cache line or more start on their own line
+    static const size_t ARENA_CACHE_LINE = 64;
+    //bytes of a chunk, larger objects get a chunk of their own
+    static const size_t ARENA_CHUNK_BYTES = 64 << 10;
+
+    //Monotonic allocator: objects are bumped into cache line aligned chunks and never freed
+    //one by one, all chunks are released at once when the arena is destroyed.
+    class arena
+    {
+    private:
+        vector<char*> chunks;
+        char* cursor = nullptr;
+        char* end = nullptr;
+        size_t bytes = 0;
+
+        static char* align_up(char* ptr, const size_t alignment)
+        {
+            uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+            return reinterpret_cast<char*>((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        }
+
+        void add_chunk(const size_t size)
+        {
+            void* chunk;
+            if(posix_memalign(&chunk, ARENA_CACHE_LINE, size) != 0)
+                throw bad_alloc();
+            chunks.push_back(static_cast<char*>(chunk));
+            cursor = static_cast<char*>(chunk);
+            end = cursor + size;
+        }
+    public:
+        arena()
+        {
+
+        }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        //size bytes aligned on alignment, a power of two no larger than a cache line, with
+        //prefix writable bytes in front of the returned address
+        void* allocate(const size_t size, const size_t alignment, const size_t prefix = 0)
+        {
+            char* ptr = cursor ? align_up(cursor + prefix, alignment) : nullptr;
+            if(!ptr || ptr + size > end)
+            {
+                add_chunk(max(ARENA_CHUNK_BYTES, size + prefix + ARENA_CACHE_LINE));
+                ptr = align_up(cursor + prefix, alignment);
+            }
+            cursor = ptr + size;
+            bytes += size;
+            return ptr;
+        }
+
+        //bytes handed out, without alignment padding
+        size_t get_bytes() const
+        {
+            return bytes;
+        }
+
+        ~arena()
+        {
+            for(auto chunk : chunks)
+                free(chunk);
+        }
+    };
+
+    //arena the allocations of this thread go to, nullptr for the heap
+    inline arena*& active_arena()
+    {
+        static thread_local arena* current = nullptr;
+        return current;
+    }
+
+    //makes an arena the active one for its lifetime, e.g. while the columns of a table
+    //are constructed; state allocated later (during generation) goes to the heap
+    class arena_scope
+    {
+    private:
+        arena* previous;
+    public:
+        arena_scope(arena& scope_arena) : previous(active_arena())
+        {
+            active_arena() = &scope_arena;
+        }
+
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
+
+        ~arena_scope()
+        {
+            active_arena() = previous;
+        }
+    };
+
+    //Every block starts with a tag telling whether it came from an arena, so the same delete
+    //works wherever the object was allocated. An arena block is only given back with its arena.
+    static const size_t ARENA_TAG_BYTES = 16;
+    static const uintptr_t HEAP_BLOCK = 0;
+    static const uintptr_t ARENA_BLOCK = 1;
+
+    inline void* arena_allocate(const size_t size)
+    {
+        char* ptr;
+        uintptr_t tag;
+        if(active_arena())
+        {
+            ptr = static_cast<char*>(active_arena()->allocate(size,
+                size >= ARENA_CACHE_LINE ? ARENA_CACHE_LINE : ARENA_TAG_BYTES, ARENA_TAG_BYTES));
+            tag = ARENA_BLOCK;
+        }
+        else
+        {
+            ptr = static_cast<char*>(::operator new(size + ARENA_TAG_BYTES)) + ARENA_TAG_BYTES;
+            tag = HEAP_BLOCK;
+        }
+        *reinterpret_cast<uintptr_t*>(ptr - ARENA_TAG_BYTES) = tag;
+        return ptr;
+    }
+
+    inline void arena_release(void* ptr)
+    {
+        if(!ptr)
+            return;
+        char* block = static_cast<char*>(ptr) - ARENA_TAG_BYTES;
+        if(*reinterpret_cast<uintptr_t*>(block) == HEAP_BLOCK)
+            ::operator delete(block);
+    }
+
+    //new and delete of a class deriving from it go through the active arena
+    struct arena_object
+    {
+        static void* operator new(size_t size)
+        {
+            return arena_allocate(size);
+        }
+
+        static void operator delete(void* ptr)
+        {
+            arena_release(ptr);
+        }
+    };
+
+    //new and delete for members of library types, e.g. a std::mt19937_64 or a std::string
+    template <typename T, typename... Args>
+    inline T* arena_new(Args&&... args)
+    {
+        void* ptr = arena_allocate(sizeof(T));
+        try
+        {
+            return new (ptr) T(std::forward<Args>(args)...);
+        }
+        catch(...)
+        {
+            arena_release(ptr);
+            throw;
+        }
+    }
+
+    template <typename T>
+    inline void arena_delete(T* ptr)
+    {
+        if(!ptr)
+            return;
+        ptr->~T();
+        arena_release(ptr);
+    }
+}
@@ -0,0 +1,735 @@
+#include "rglibinc.hpp"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <condition_variable>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+//io_uring is driven through raw syscalls, so only the kernel header is needed
+#if defined(__linux__) && defined(__has_include) && !defined(REDGENE_NO_IO_URING)
+#if __has_include(<linux/io_uring.h>)
+#define REDGENE_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace redgene
+{
+    //O_DIRECT transfers are aligned to this many bytes in memory, length and file offset
+    static const size_t DIRECT_IO_ALIGN = 4096;
+    //staging block of the direct writer, a full block is one write
+    static const size_t DIRECT_BLOCK_BYTES = 1 << 20;
+    //writes kept in flight per file by the direct writer
+    static const unsigned int DIRECT_IO_DEPTH = 4;
+
+    typedef struct io_completion
+    {
+        size_t tag;
+        //bytes written, or -errno
+        ssize_t result;
+    } io_completion;
+
+    //Abstract Base Class for asynchronous positional writes. Writes are identified by a tag
+    //and reaped in completion order.
+    class async_io
+    {
+    public:
+        virtual ~async_io()
+        {
+
+        }
+        virtual void submit(const int fd, const size_t tag, const char* data, const size_t size,
+            const uint_fast64_t offset) = 0;
+        virtual io_completion wait_one() = 0;
+        virtual const char* name() const = 0;
+    };
+
+#ifdef REDGENE_HAVE_IO_URING
+    //single issuer io_uring with one WRITEV per submission, throws if the kernel (or a
+    //seccomp policy) does not allow io_uring so the caller can fall back.
+    class uring_io : public async_io
+    {
+    private:
+        int ring_fd = -1;
+        void* sq_ring = MAP_FAILED;
+        void* cq_ring = MAP_FAILED;
+        size_t sq_ring_bytes = 0;
+        size_t cq_ring_bytes = 0;
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t sqes_bytes = 0;
+        unsigned *sq_tail, *sq_mask, *sq_array;
+        unsigned *cq_head, *cq_tail, *cq_mask;
+        io_uring_cqe* cqes;
+        vector<iovec> iovecs;
+
+        void release()
+        {
+            if(sqes != MAP_FAILED)
+                munmap(sqes, sqes_bytes);
+            if(cq_ring != MAP_FAILED && cq_ring != sq_ring)
+                munmap(cq_ring, cq_ring_bytes);
+            if(sq_ring != MAP_FAILED)
+                munmap(sq_ring, sq_ring_bytes);
+            if(ring_fd >= 0)
+                close(ring_fd);
+        }
+
+        void* map_ring(const size_t bytes, const off_t ring_offset)
+        {
+            void* ring = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, 
+                ring_fd, ring_offset);
+            if(ring == MAP_FAILED)
+            {
+                release();
+                throw runtime_error(string("unable to map io_uring: ") + strerror(errno));
+            }
+            return ring;
+        }
+    public:
+        uring_io(const unsigned int depth, const size_t tags) : iovecs(tags)
+        {
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            ring_fd = syscall(__NR_io_uring_setup, depth, &params);
+            if(ring_fd < 0)
+                throw runtime_error(string("io_uring unavailable: ") + strerror(errno));
+
+            sq_ring_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_ring_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            if(params.features & IORING_FEAT_SINGLE_MMAP)
+                sq_ring_bytes = cq_ring_bytes = max(sq_ring_bytes, cq_ring_bytes);
+            sq_ring = map_ring(sq_ring_bytes, IORING_OFF_SQ_RING);
+            cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP) ? sq_ring :
+                map_ring(cq_ring_bytes, IORING_OFF_CQ_RING);
+            sqes_bytes = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(map_ring(sqes_bytes, IORING_OFF_SQES));
+
+            char* sq = static_cast<char*>(sq_ring);
+            char* cq = static_cast<char*>(cq_ring);
+            sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+
+        uring_io(const uring_io&) = delete;
+        uring_io& operator=(const uring_io&) = delete;
+
+        ~uring_io()
+        {
+            release();
+        }
+
+        void submit(const int fd, const size_t tag, const char* data, const size_t size,
+            const uint_fast64_t offset)
+        {
+            iovecs[tag].iov_base = const_cast<char*>(data);
+            iovecs[tag].iov_len = size;
+
+            unsigned tail = *sq_tail;
+            unsigned idx = tail & *sq_mask;
+            io_uring_sqe* sqe = &sqes[idx];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_WRITEV;
+            sqe->fd = fd;
+            sqe->off = offset;
+            sqe->addr = reinterpret_cast<uint64_t>(&iovecs[tag]);
+            sqe->len = 1;
+            sqe->user_data = tag;
+            sq_array[idx] = idx;
+            __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+            while(syscall(__NR_io_uring_enter, ring_fd, 1, 0, 0, nullptr, 0) < 0)
+            {
+                if(errno != EINTR)
+                    throw runtime_error(string("io_uring submit failed: ") + strerror(errno));
+            }
+        }
+
+        io_completion wait_one()
+        {
+            unsigned head = *cq_head;
+            while(head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+            {
+                if(syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 
+                    && errno != EINTR)
+                    throw runtime_error(string("io_uring wait failed: ") + strerror(errno));
+            }
+            io_uring_cqe* cqe = &cqes[head & *cq_mask];
+            io_completion completion;
+            completion.tag = cqe->user_data;
+            completion.result = cqe->res;
+            __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+            return completion;
+        }
+
+        const char* name() const
+        {
+            return "io_uring";
+        }
+    };
+#endif
+
+    //fallback when io_uring is not available: worker threads issuing pwrite()
+    class pwrite_pool_io : public async_io
+    {
+    private:
+        typedef struct write_job
+        {
+            int fd;
+            size_t tag;
+            const char* data;
+            size_t size;
+            uint_fast64_t offset;
+        } write_job;
+
+        mutex mtx;
+        condition_variable job_ready;
+        condition_variable job_done;
+        deque<write_job> jobs;
+        deque<io_completion> completions;
+        vector<thread> workers;
+        bool stopping = false;
+
+        static ssize_t pwrite_all(const write_job& job)
+        {
+            size_t done = 0;
+            while(done < job.size)
+            {
+                ssize_t written = pwrite(job.fd, job.data + done, job.size - done, job.offset + done);
+                if(written < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+                    return -errno;
+                }
+                done += written;
+            }
+            return done;
+        }
+
+        void run()
+        {
+            unique_lock<mutex> lock(mtx);
+            while(true)
+            {
+                job_ready.wait(lock, [this]{ return stopping || !jobs.empty(); });
+                if(jobs.empty())
+                    return;
+                write_job job = jobs.front();
+                jobs.pop_front();
+                lock.unlock();
+                io_completion completion;
+                completion.tag = job.tag;
+                completion.result = pwrite_all(job);
+                lock.lock();
+                completions.push_back(completion);
+                job_done.notify_one();
+            }
+        }
+    public:
+        pwrite_pool_io(const unsigned int depth)
+        {
+            for(unsigned int i = 0; i < depth; ++i)
+                workers.push_back(thread(&pwrite_pool_io::run, this));
+        }
+
+        ~pwrite_pool_io()
+        {
+            {
+                lock_guard<mutex> lock(mtx);
+                stopping = true;
+            }
+            job_ready.notify_all();
+            for(auto& worker : workers)
+                worker.join();
+        }
+
+        void submit(const int fd, const size_t tag, const char* data, const size_t size,
+            const uint_fast64_t offset)
+        {
+            write_job job = {fd, tag, data, size, offset};
+            lock_guard<mutex> lock(mtx);
+            jobs.push_back(job);
+            job_ready.notify_one();
+        }
+
+        io_completion wait_one()
+        {
+            unique_lock<mutex> lock(mtx);
+            job_done.wait(lock, [this]{ return !completions.empty(); });
+            io_completion completion = completions.front();
+            completions.pop_front();
+            return completion;
+        }
+
+        const char* name() const
+        {
+            return "pwrite pool";
+        }
+    };
+
+    //Writes a file through aligned staging blocks with up to DIRECT_IO_DEPTH block writes in
+    //flight. With O_DIRECT the data bypasses the page cache; the partial last block is
+    //written padded and the file is truncated back to its real size by finish().
+    class async_file_writer
+    {
+    private:
+        int fd;
+        bool direct;
+        async_io* io = nullptr;
+        vector<char*> blocks;
+        vector<size_t> submitted_bytes;
+        vector<size_t> free_blocks;
+        size_t current;
+        size_t fill = 0;
+        uint_fast64_t block_offset;
+        uint_fast64_t file_size;
+        unsigned int in_flight = 0;
+
+        void reap()
+        {
+            io_completion completion = io->wait_one();
+            --in_flight;
+            free_blocks.push_back(completion.tag);
+            if(completion.result < 0)
+                throw runtime_error(string("asynchronous write failed: ") + strerror(-completion.result));
+            if(static_cast<size_t>(completion.result) != submitted_bytes[completion.tag])
+                throw runtime_error("asynchronous write was cut short!");
+        }
+
+        void submit_current(const size_t bytes)
+        {
+            submitted_bytes[current] = bytes;
+            io->submit(fd, current, blocks[current], bytes, block_offset);
+            ++in_flight;
+        }
+
+        void wait_all()
+        {
+            while(in_flight > 0)
+                reap();
+        }
+
+        void release()
+        {
+            //the kernel may still be writing from the blocks
+            while(in_flight > 0)
+            {
+                io->wait_one();
+                --in_flight;
+            }
+            delete io;
+            io = nullptr;
+            for(auto block : blocks)
+                free(block);
+            blocks.clear();
+        }
+    public:
+        async_file_writer(const int fd, const bool direct, const uint_fast64_t start_offset) :
+            fd(fd), direct(direct), blocks(DIRECT_IO_DEPTH + 1, nullptr), 
+            submitted_bytes(DIRECT_IO_DEPTH + 1, 0), file_size(start_offset)
+        {
+            for(size_t i = 0; i < blocks.size(); ++i)
+            {
+                void* block;
+                if(posix_memalign(&block, DIRECT_IO_ALIGN, DIRECT_BLOCK_BYTES) != 0)
+                {
+                    for(size_t j = 0; j < i; ++j)
+                        free(blocks[j]);
+                    throw bad_alloc();
+                }
+                blocks[i] = static_cast<char*>(block);
+                if(i > 0)
+                    free_blocks.push_back(i);
+            }
+            current = 0;
+
+#ifdef REDGENE_HAVE_IO_URING
+            try
+            {
+                io = new uring_io(DIRECT_IO_DEPTH, blocks.size());
+            }
+            catch(const runtime_error&)
+            {
+                io = nullptr;
+            }
+#endif
+            if(!io)
+                io = new pwrite_pool_io(DIRECT_IO_DEPTH);
+
+            //continue inside the aligned block holding start_offset, keeping its head
+            block_offset = start_offset - start_offset % DIRECT_IO_ALIGN;
+            fill = start_offset - block_offset;
+            if(fill > 0 && pread(fd, blocks[current], DIRECT_IO_ALIGN, block_offset) < 
+                static_cast<ssize_t>(fill))
+            {
+                release();
+                throw runtime_error(string("unable to read back the partial block: ") + strerror(errno));
+            }
+        }
+
+        async_file_writer(const async_file_writer&) = delete;
+        async_file_writer& operator=(const async_file_writer&) = delete;
+
+        ~async_file_writer()
+        {
+            release();
+        }
+
+        void append(const char* data, size_t size)
+        {
+            while(size > 0)
+            {
+                size_t chunk = min(size, DIRECT_BLOCK_BYTES - fill);
+                memcpy(blocks[current] + fill, data, chunk);
+                fill += chunk;
+                data += chunk;
+                size -= chunk;
+                file_size += chunk;
+
+                if(fill == DIRECT_BLOCK_BYTES)
+                {
+                    submit_current(DIRECT_BLOCK_BYTES);
+                    block_offset += DIRECT_BLOCK_BYTES;
+                    fill = 0;
+                    if(free_blocks.empty())
+                        reap();
+                    current = free_blocks.back();
+                    free_blocks.pop_back();
+                }
+            }
+        }
+
+        //everything appended so far is in the file once this returns, the partial block is
+        //written padded and stays current so later appends complete it in place.
+        void sync()
+        {
+            if(fill > 0)
+            {
+                size_t padded = (fill + DIRECT_IO_ALIGN - 1) / DIRECT_IO_ALIGN * DIRECT_IO_ALIGN;
+                memset(blocks[current] + fill, 0, padded - fill);
+                submit_current(padded);
+            }
+            wait_all();
+            //the partial block went out from current, take it back from the free list
+            if(fill > 0)
+                free_blocks.erase(find(free_blocks.begin(), free_blocks.end(), current));
+        }
+
+        void finish()
+        {
+            sync();
+            if(ftruncate(fd, file_size) != 0)
+                throw runtime_error(string("unable to trim the padded tail: ") + strerror(errno));
+        }
+
+        bool is_direct() const
+        {
+            return direct;
+        }
+
+        const char* backend_name() const
+        {
+            return io->name();
+        }
+    };
+
+    //fraction of a file's pages resident in the page cache, -1 if it cannot be measured
+    inline double page_cache_residency(const string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return -1;
+        struct stat file_stat;
+        double residency = -1;
+        if(fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode))
+        {
+            size_t file_bytes = file_stat.st_size;
+            if(file_bytes == 0)
+                residency = 0;
+            else
+            {
+                void* mapping = mmap(nullptr, file_bytes, PROT_READ, MAP_SHARED, fd, 0);
+                if(mapping != MAP_FAILED)
+                {
+                    size_t page_bytes = sysconf(_SC_PAGESIZE);
+                    size_t pages = (file_bytes + page_bytes - 1) / page_bytes;
+                    vector<unsigned char> resident(pages);
+                    if(mincore(mapping, file_bytes, resident.data()) == 0)
+                        residency = count_if(resident.begin(), resident.end(), 
+                            [](unsigned char page){ return page & 1; }) / static_cast<double>(pages);
+                    munmap(mapping, file_bytes);
+                }
+            }
+        }
+        close(fd);
+        return residency;
+    }
+
+    //Destination of the bytes generated for one table. The output spec is either "-" (stdout),
+    //"fifo:<path>" (a named pipe, created when missing) or a file path; "%t" in a path is
+    //replaced by the table name.
+    class output_target
+    {
+    private:
+        int fd = -1;
+        bool owns_fd = false;
+        bool regular_file = false;
+        string path;
+        uint_fast64_t bytes_written = 0;
+        async_file_writer* file_writer = nullptr;
+
+        void throw_io_error(const string& what) const
+        {
+            throw runtime_error(what + " " + path + ": " + strerror(errno));
+        }
+    public:
+        static string resolve_path(string path, const string& table_name)
+        {
+            for(auto pos = path.find("%t"); pos != string::npos; pos = path.find("%t", pos))
+            {
+                path.replace(pos, 2, table_name);
+                pos += table_name.size();
+            }
+            return path;
+        }
+
+        //resume reopens an existing regular file and truncates it back to resume_offset,
+        //direct_io writes regular files through an async_file_writer with O_DIRECT
+        output_target(const string& spec, const string& table_name, const bool resume = false,
+            const uint_fast64_t resume_offset = 0, const bool direct_io = false)
+        {
+            if(spec == "-")
+            {
+                fd = STDOUT_FILENO;
+                path = "<stdout>";
+                return;
+            }
+
+            if(spec.compare(0, 5, "fifo:") == 0)
+            {
+                path = resolve_path(spec.substr(5), table_name);
+                if(mkfifo(path.c_str(), 0644) != 0 && errno != EEXIST)
+                    throw_io_error("unable to create named pipe");
+                //blocks until the consumer opens the other end
+                fd = open(path.c_str(), O_WRONLY);
+            }
+            else
+            {
+                path = resolve_path(spec, table_name);
+                //the direct writer reads back the partial block it resumes in
+                fd = open(path.c_str(), (direct_io ? O_RDWR : O_WRONLY) | O_CREAT | 
+                    (resume ? 0 : O_TRUNC), 0644);
+            }
+            if(fd < 0)
+                throw_io_error("unable to open");
+            owns_fd = true;
+
+            struct stat target_stat;
+            regular_file = (fstat(fd, &target_stat) == 0) && S_ISREG(target_stat.st_mode);
+
+            if(resume)
+            {
+                if(!regular_file)
+                    throw runtime_error("only regular files can be resumed, " + path + " is not one!");
+                if(ftruncate(fd, resume_offset) != 0 || lseek(fd, 0, SEEK_END) < 0)
+                    throw_io_error("unable to truncate for resume");
+                bytes_written = resume_offset;
+            }
+
+            if(direct_io && regular_file)
+            {
+                //filesystems like tmpfs refuse O_DIRECT, they still get the async writes
+                int flags = fcntl(fd, F_GETFL);
+                bool direct = flags >= 0 && fcntl(fd, F_SETFL, flags | O_DIRECT) == 0;
+                file_writer = new async_file_writer(fd, direct, bytes_written);
+            }
+        }
+
+        output_target(const output_target&) = delete;
+        output_target& operator=(const output_target&) = delete;
+
+        ~output_target()
+        {
+            delete file_writer;
+            if(owns_fd && fd >= 0)
+                close(fd);
+        }
+
+        void write_all(const char* data, size_t size)
+        {
+            if(file_writer)
+            {
+                file_writer->append(data, size);
+                bytes_written += size;
+                return;
+            }
+            while(size > 0)
+            {
+                ssize_t written = write(fd, data, size);
+                if(written < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+                    throw_io_error("write failed on");
+                }
+                data += written;
+                size -= written;
+                bytes_written += written;
+            }
+        }
+
+        //makes every byte written so far part of the file, needed before checkpointing
+        void sync()
+        {
+            if(file_writer)
+                file_writer->sync();
+        }
+
+        //completes outstanding writes, must be called once the last byte is written
+        void finish()
+        {
+            if(file_writer)
+                file_writer->finish();
+        }
+
+        string writer_name() const
+        {
+            if(!file_writer)
+                return "buffered";
+            return string(file_writer->backend_name()) + (file_writer->is_direct() ? " + O_DIRECT" : "");
+        }
+
+        //pipes and stdout can neither be truncated nor reopened, so they are not checkpointed
+        bool is_regular_file() const
+        {
+            return regular_file;
+        }
+
+        uint_fast64_t get_bytes_written() const
+        {
+            return bytes_written;
+        }
+
+        const string& get_path() const
+        {
+            return path;
+        }
+    };
+
+    //waits of a pipeline stage: spin briefly, then yield, then sleep so a stage stalled on
+    //a slow disk does not burn a core
+    class backoff
+    {
+    private:
+        unsigned int rounds = 0;
+    public:
+        void pause()
+        {
+            if(rounds < 64)
+                ++rounds;
+            else if(rounds < 128)
+            {
+                ++rounds;
+                this_thread::yield();
+            }
+            else
+                this_thread::sleep_for(chrono::microseconds(50));
+        }
+    };
+
+    //bounded lock-free ring between exactly one producer thread and one consumer thread.
+    //close() ends the stream once drained, abort() releases both sides at once on errors.
+    template <typename T>
+    class spsc_ring
+    {
+    private:
+        vector<T> slots;
+        size_t mask;
+        //producer and consumer indices on their own cache lines
+        alignas(64) atomic<size_t> head;
+        alignas(64) atomic<size_t> tail;
+        alignas(64) atomic<bool> closed;
+        atomic<bool> aborted;
+    public:
+        spsc_ring(const size_t capacity) : head(0), tail(0), closed(false), aborted(false)
+        {
+            size_t ring_size = 1;
+            while(ring_size < capacity)
+                ring_size <<= 1;
+            slots.resize(ring_size);
+            mask = ring_size - 1;
+        }
+
+        bool try_push(const T& item)
+        {
+            size_t t = tail.load(memory_order_relaxed);
+            if(t - head.load(memory_order_acquire) == slots.size())
+                return false;
+            slots[t & mask] = item;
+            tail.store(t + 1, memory_order_release);
+            return true;
+        }
+
+        bool try_pop(T& item)
+        {
+            size_t h = head.load(memory_order_relaxed);
+            if(h == tail.load(memory_order_acquire))
+                return false;
+            item = slots[h & mask];
+            head.store(h + 1, memory_order_release);
+            return true;
+        }
+
+        //false if the ring was aborted
+        bool push(const T& item)
+        {
+            backoff wait;
+            while(!try_push(item))
+            {
+                if(aborted.load(memory_order_acquire))
+                    return false;
+                wait.pause();
+            }
+            return true;
+        }
+
+        //false once the ring is closed and drained, or aborted
+        bool pop(T& item)
+        {
+            backoff wait;
+            while(!try_pop(item))
+            {
+                if(aborted.load(memory_order_acquire))
+                    return false;
+                if(closed.load(memory_order_acquire))
+                    return try_pop(item);
+                wait.pause();
+            }
+            return true;
+        }
+
+        void close()
+        {
+            closed.store(true, memory_order_release);
+        }
+
+        void abort()
+        {
+            aborted.store(true, memory_order_release);
+        }
+    };
+}
@@ -0,0 +1,275 @@
+#include "rglibinc.hpp"
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+
+//Compiled schema plans: a validated, resolved schema stored in a compact binary form that
+//loads without parsing text or validating again. Needs json.hpp to be included first.
+namespace redgene
+{
+    //Layout: the 8 byte magic "RGPLAN" 0 <version>, a table of every distinct string (keys
+    //and string values, each stored once), then the json tree in preorder. A node is a tag
+    //byte followed by its payload; counts, string indices and integers are LEB128 varints.
+    class compiled_plan
+    {
+    private:
+        static const uint8_t VERSION = 1;
+        enum tags : uint8_t { NIL, FALSE_VALUE, TRUE_VALUE, UNSIGNED, SIGNED, REAL, TEXT, ARRAY, OBJECT };
+
+        static const char* magic()
+        {
+            return "RGPLAN";
+        }
+
+        static void put_varint(string& out, uint_fast64_t value)
+        {
+            while(value >= 0x80)
+            {
+                out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        static void collect_strings(const nlohmann::json& node, unordered_map<string, uint_fast64_t>& index,
+            vector<const string*>& strings)
+        {
+            auto intern = [&](const string& str)
+            {
+                auto entry = index.emplace(str, strings.size());
+                if(entry.second)
+                    strings.push_back(&entry.first->first);
+            };
+            if(node.is_string())
+                intern(node.get_ref<const string&>());
+            else if(node.is_array())
+                for(auto& element : node)
+                    collect_strings(element, index, strings);
+            else if(node.is_object())
+                for(auto itr = node.begin(); itr != node.end(); ++itr)
+                {
+                    intern(itr.key());
+                    collect_strings(itr.value(), index, strings);
+                }
+        }
+
+        static void encode(const nlohmann::json& node, const unordered_map<string, uint_fast64_t>& index,
+            string& out)
+        {
+            switch(node.type())
+            {
+                case nlohmann::json::value_t::null:
+                    out.push_back(NIL);
+                    break;
+                case nlohmann::json::value_t::boolean:
+                    out.push_back(node.get<bool>() ? TRUE_VALUE : FALSE_VALUE);
+                    break;
+                case nlohmann::json::value_t::number_unsigned:
+                    out.push_back(UNSIGNED);
+                    put_varint(out, node.get<uint_fast64_t>());
+                    break;
+                case nlohmann::json::value_t::number_integer:
+                {
+                    //zigzag, so small negative numbers stay short
+                    int64_t value = node.get<int64_t>();
+                    out.push_back(SIGNED);
+                    put_varint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+                    break;
+                }
+                case nlohmann::json::value_t::number_float:
+                {
+                    double value = node.get<double>();
+                    char bytes[sizeof(double)];
+                    memcpy(bytes, &value, sizeof(double));
+                    out.push_back(REAL);
+                    out.append(bytes, sizeof(double));
+                    break;
+                }
+                case nlohmann::json::value_t::string:
+                    out.push_back(TEXT);
+                    put_varint(out, index.find(node.get_ref<const string&>())->second);
+                    break;
+                case nlohmann::json::value_t::array:
+                    out.push_back(ARRAY);
+                    put_varint(out, node.size());
+                    for(auto& element : node)
+                        encode(element, index, out);
+                    break;
+                case nlohmann::json::value_t::object:
+                    out.push_back(OBJECT);
+                    put_varint(out, node.size());
+                    for(auto itr = node.begin(); itr != node.end(); ++itr)
+                    {
+                        put_varint(out, index.find(itr.key())->second);
+                        encode(itr.value(), index, out);
+                    }
+                    break;
+                default:
+                    throw runtime_error("unsupported json value in a compiled plan!");
+            }
+        }
+
+        //reads a plan held in memory, every read is bounds checked
+        class decoder
+        {
+        private:
+            const char* cursor;
+            const char* end;
+            vector<string> strings;
+
+            uint8_t get_byte()
+            {
+                if(cursor == end)
+                    throw runtime_error("compiled plan is truncated!");
+                return static_cast<uint8_t>(*cursor++);
+            }
+
+            uint_fast64_t get_varint()
+            {
+                uint_fast64_t value = 0;
+                for(unsigned int shift = 0; shift < 64; shift += 7)
+                {
+                    uint8_t byte = get_byte();
+                    value |= static_cast<uint_fast64_t>(byte & 0x7F) << shift;
+                    if(!(byte & 0x80))
+                        return value;
+                }
+                throw runtime_error("compiled plan holds a malformed number!");
+            }
+
+            const string& get_string()
+            {
+                uint_fast64_t position = get_varint();
+                if(position >= strings.size())
+                    throw runtime_error("compiled plan refers to a missing string!");
+                return strings[position];
+            }
+        public:
+            decoder(const string& data) : cursor(data.data()), end(data.data() + data.size())
+            {
+                if(data.size() < 8 || memcmp(cursor, magic(), 6) != 0 || cursor[6] != 0)
+                    throw runtime_error("not a compiled redgene plan!");
+                if(static_cast<uint8_t>(cursor[7]) != VERSION)
+                    throw runtime_error("compiled plan version "+to_string(static_cast<uint8_t>(cursor[7]))+
+                        " is not supported, recompile the schema!");
+                cursor += 8;
+                uint_fast64_t string_count = get_varint();
+                if(string_count > static_cast<uint_fast64_t>(end - cursor))
+                    throw runtime_error("compiled plan is truncated!");
+                strings.resize(string_count);
+                for(auto& str : strings)
+                {
+                    uint_fast64_t length = get_varint();
+                    if(length > static_cast<uint_fast64_t>(end - cursor))
+                        throw runtime_error("compiled plan is truncated!");
+                    str.assign(cursor, length);
+                    cursor += length;
+                }
+            }
+
+            void decode(nlohmann::json& node)
+            {
+                switch(get_byte())
+                {
+                    case NIL:
+                        node = nullptr;
+                        break;
+                    case FALSE_VALUE:
+                        node = false;
+                        break;
+                    case TRUE_VALUE:
+                        node = true;
+                        break;
+                    case UNSIGNED:
+                        node = static_cast<uint64_t>(get_varint());
+                        break;
+                    case SIGNED:
+                    {
+                        uint64_t value = get_varint();
+                        node = static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+                        break;
+                    }
+                    case REAL:
+                    {
+                        double value;
+                        if(end - cursor < static_cast<ptrdiff_t>(sizeof(double)))
+                            throw runtime_error("compiled plan is truncated!");
+                        memcpy(&value, cursor, sizeof(double));
+                        cursor += sizeof(double);
+                        node = value;
+                        break;
+                    }
+                    case TEXT:
+                        node = get_string();
+                        break;
+                    case ARRAY:
+                    {
+                        uint_fast64_t size = get_varint();
+                        node = nlohmann::json::array();
+                        for(uint_fast64_t i = 0; i < size; ++i)
+                        {
+                            node.push_back(nullptr);
+                            decode(node.back());
+                        }
+                        break;
+                    }
+                    case OBJECT:
+                    {
+                        uint_fast64_t size = get_varint();
+                        node = nlohmann::json::object();
+                        for(uint_fast64_t i = 0; i < size; ++i)
+                        {
+                            const string& key = get_string();
+                            decode(node[key]);
+                        }
+                        break;
+                    }
+                    default:
+                        throw runtime_error("compiled plan holds an unknown value!");
+                }
+            }
+        };
+    public:
+        //whether the file starts with the plan magic, a schema template never does
+        static bool is_plan_file(const string& filename)
+        {
+            char header[6];
+            ifstream ifstrm(filename, ios::binary);
+            return ifstrm.read(header, sizeof(header)) && memcmp(header, magic(), sizeof(header)) == 0;
+        }
+
+        static void save(const string& filename, const nlohmann::json& plan)
+        {
+            unordered_map<string, uint_fast64_t> index;
+            vector<const string*> strings;
+            collect_strings(plan, index, strings);
+
+            string out(magic(), 6);
+            out.push_back(0);
+            out.push_back(static_cast<char>(VERSION));
+            put_varint(out, strings.size());
+            for(auto str : strings)
+            {
+                put_varint(out, str->size());
+                out.append(*str);
+            }
+            encode(plan, index, out);
+
+            ofstream ofstrm(filename, ios::binary | ios::trunc);
+            if(!ofstrm.write(out.data(), out.size()) || !ofstrm.flush())
+                throw runtime_error("failed to write the compiled plan "+filename+"!");
+        }
+
+        static nlohmann::json load(const string& filename)
+        {
+            ifstream ifstrm(filename, ios::binary);
+            if(!ifstrm)
+                throw runtime_error("failed to open the compiled plan "+filename+"!");
+            string data((istreambuf_iterator<char>(ifstrm)), istreambuf_iterator<char>());
+            decoder plan_decoder(data);
+            nlohmann::json plan;
+            plan_decoder.decode(plan);
+            return plan;
+        }
+    };
+}
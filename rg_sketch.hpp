@@ -0,0 +1,221 @@
+#include "rglibinc.hpp"
+#include <unordered_map>
+#include <cstdint>
+
+//Streaming summaries of a column, each in a fixed amount of memory whatever the number of
+//rows. Values are hashed with mix64 and fnv1a_hash64, so this follows rand_engine.hpp and
+//rg_utils.hpp in redgene.hpp.
+namespace redgene
+{
+    //number of distinct values, HyperLogLog with 2^precision one byte registers;
+    //the standard error is 1.04 / sqrt(2^precision), 0.8% at the default precision
+    class hyperloglog
+    {
+    private:
+        unsigned int precision;
+        vector<uint8_t> registers;
+    public:
+        hyperloglog(const unsigned int precision = 14) : precision(precision),
+            registers(static_cast<size_t>(1) << precision, 0)
+        {
+
+        }
+
+        inline void add_hash(const uint_fast64_t hash)
+        {
+            size_t index = hash >> (64 - precision);
+            uint_fast64_t rest = hash << precision;
+            uint8_t rank = 1;
+            while(rank <= 64 - precision && !(rest & (1ULL << 63)))
+            {
+                rest <<= 1;
+                ++rank;
+            }
+            if(rank > registers[index])
+                registers[index] = rank;
+        }
+
+        inline void add(const char* data, const size_t size)
+        {
+            add_hash(mix64(fnv1a_hash64(data, size)));
+        }
+
+        double estimate() const
+        {
+            double m = registers.size();
+            double sum = 0;
+            size_t zeros = 0;
+            for(uint8_t reg : registers)
+            {
+                sum += ldexp(1.0, -reg);
+                zeros += (reg == 0);
+            }
+            double raw = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+            //few values: linear counting over the empty registers is more accurate
+            if(raw <= 2.5 * m && zeros > 0)
+                return m * log(m / zeros);
+            return raw;
+        }
+    };
+
+    //most frequent values, Space-Saving with a fixed number of counters. A value that is not
+    //tracked replaces the smallest counter and inherits its count as its error, so every
+    //count is an upper bound of the true count and count - error a lower bound.
+    class space_saving
+    {
+    public:
+        typedef struct counter
+        {
+            string value;
+            uint_fast64_t count;
+            uint_fast64_t error;
+        } counter;
+    private:
+        size_t capacity;
+        vector<counter> counters;
+        unordered_map<string, size_t> index;
+        bool evicted = false;
+    public:
+        space_saving(const size_t capacity = 64) : capacity(capacity)
+        {
+
+        }
+
+        void add(const string& value)
+        {
+            auto itr = index.find(value);
+            if(itr != index.end())
+            {
+                ++counters[itr->second].count;
+                return;
+            }
+            if(counters.size() < capacity)
+            {
+                index.emplace(value, counters.size());
+                counters.push_back({value, 1, 0});
+                return;
+            }
+            size_t smallest = 0;
+            for(size_t i = 1; i < counters.size(); ++i)
+                if(counters[i].count < counters[smallest].count)
+                    smallest = i;
+            index.erase(counters[smallest].value);
+            index.emplace(value, smallest);
+            counters[smallest].value = value;
+            counters[smallest].error = counters[smallest].count;
+            ++counters[smallest].count;
+            evicted = true;
+        }
+
+        //counters by decreasing count
+        vector<counter> top() const
+        {
+            vector<counter> sorted(counters);
+            sort(sorted.begin(), sorted.end(), [](const counter& a, const counter& b)
+                { return a.count > b.count || (a.count == b.count && a.value < b.value); });
+            return sorted;
+        }
+
+        //without evictions the counts are exact and every distinct value is tracked
+        bool is_exact() const
+        {
+            return !evicted;
+        }
+    };
+
+    //set membership in a fixed number of bits, a Bloom filter with k probes from double
+    //hashing; there are no false negatives, false positives at the rate fill^k
+    class bloom_filter
+    {
+    private:
+        vector<uint64_t> bits;
+        uint_fast64_t bit_count;
+        uint_fast64_t set_bits = 0;
+        unsigned int probes;
+    public:
+        bloom_filter(const uint_fast64_t expected_items, const double bits_per_item = 16,
+            const uint_fast64_t max_bytes = 256ULL << 20)
+        {
+            bit_count = max<uint_fast64_t>(64, min<uint_fast64_t>(expected_items * bits_per_item, max_bytes * 8));
+            bits.assign((bit_count + 63) / 64, 0);
+            double per_item = static_cast<double>(bit_count) / max<uint_fast64_t>(1, expected_items);
+            probes = max(1, min(16, static_cast<int>(lround(per_item * log(2.0)))));
+        }
+
+        //adds a hashed value and returns whether it may have been there already
+        bool add(const uint_fast64_t hash)
+        {
+            uint_fast64_t h1 = hash, h2 = mix64(hash) | 1;
+            bool present = true;
+            for(unsigned int i = 0; i < probes; ++i)
+            {
+                uint_fast64_t bit = (h1 + i * h2) % bit_count;
+                uint64_t mask = 1ULL << (bit & 63);
+                if(bits[bit >> 6] & mask)
+                    continue;
+                present = false;
+                bits[bit >> 6] |= mask;
+                ++set_bits;
+            }
+            return present;
+        }
+
+        bool contains(const uint_fast64_t hash) const
+        {
+            uint_fast64_t h1 = hash, h2 = mix64(hash) | 1;
+            for(unsigned int i = 0; i < probes; ++i)
+            {
+                uint_fast64_t bit = (h1 + i * h2) % bit_count;
+                if(!(bits[bit >> 6] & (1ULL << (bit & 63))))
+                    return false;
+            }
+            return true;
+        }
+
+        //chance that a value never added is reported present, at the current fill
+        double false_positive_rate() const
+        {
+            return pow(static_cast<double>(set_bits) / bit_count, probes);
+        }
+
+        uint_fast64_t get_bytes() const
+        {
+            return bits.size() * sizeof(uint64_t);
+        }
+    };
+
+    //uniform sample of a stream, reservoir sampling (algorithm R) with a fixed seed so the
+    //same input always gives the same sample
+    template <typename T>
+    class reservoir_sample
+    {
+    private:
+        size_t capacity;
+        uint_fast64_t seen = 0;
+        vector<T> sample;
+        mt19937_64 prng;
+    public:
+        reservoir_sample(const size_t capacity = 16384) : capacity(capacity)
+        {
+
+        }
+
+        void add(const T& value)
+        {
+            ++seen;
+            if(sample.size() < capacity)
+                sample.push_back(value);
+            else
+            {
+                uint_fast64_t slot = prng() % seen;
+                if(slot < capacity)
+                    sample[slot] = value;
+            }
+        }
+
+        const vector<T>& get_sample() const
+        {
+            return sample;
+        }
+    };
+}
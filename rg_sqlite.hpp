@@ -0,0 +1,108 @@
+#include "rglibinc.hpp"
+#include <sqlite3.h>
+
+//Thin wrappers over the SQLite C API for the "sqlite:<path>" output, errors become
+//runtime_error. Only included when built with REDGENE_HAVE_SQLITE (make SQLITE=1), which
+//also links libsqlite3.
+namespace redgene
+{
+    class sqlite_database
+    {
+    private:
+        sqlite3* db = nullptr;
+        string path;
+    public:
+        sqlite_database(const string& path) : path(path)
+        {
+            if(sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                nullptr) != SQLITE_OK)
+            {
+                string error = db ? sqlite3_errmsg(db) : "out of memory";
+                sqlite3_close(db);
+                throw runtime_error("unable to open sqlite database " + path + ": " + error);
+            }
+        }
+
+        sqlite_database(const sqlite_database&) = delete;
+        sqlite_database& operator=(const sqlite_database&) = delete;
+
+        //runs one or more statements that return no rows
+        void exec(const string& sql)
+        {
+            char* error = nullptr;
+            if(sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK)
+            {
+                string message = error ? error : sqlite3_errmsg(db);
+                sqlite3_free(error);
+                throw runtime_error("sqlite " + path + ": " + message + " in " + sql);
+            }
+        }
+
+        void throw_error(const string& what) const
+        {
+            throw runtime_error("sqlite " + path + ": " + what + ": " + sqlite3_errmsg(db));
+        }
+
+        sqlite3* handle()
+        {
+            return db;
+        }
+
+        //an open transaction is rolled back
+        ~sqlite_database()
+        {
+            sqlite3_close(db);
+        }
+    };
+
+    //prepared statement, columns are bound from 1; text is not copied and must stay valid
+    //until step()
+    class sqlite_statement
+    {
+    private:
+        sqlite_database& db;
+        sqlite3_stmt* stmt = nullptr;
+    public:
+        sqlite_statement(sqlite_database& db, const string& sql) : db(db)
+        {
+            if(sqlite3_prepare_v2(db.handle(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+                db.throw_error("unable to prepare " + sql);
+        }
+
+        sqlite_statement(const sqlite_statement&) = delete;
+        sqlite_statement& operator=(const sqlite_statement&) = delete;
+
+        inline void bind_int(const int idx, const int_fast64_t value)
+        {
+            sqlite3_bind_int64(stmt, idx, value);
+        }
+
+        inline void bind_real(const int idx, const double value)
+        {
+            sqlite3_bind_double(stmt, idx, value);
+        }
+
+        inline void bind_text(const int idx, const char* data, const size_t size)
+        {
+            sqlite3_bind_text(stmt, idx, data, static_cast<int>(size), SQLITE_STATIC);
+        }
+
+        inline void bind_null(const int idx)
+        {
+            sqlite3_bind_null(stmt, idx);
+        }
+
+        //runs a statement that returns no rows and makes it ready for the next bindings
+        inline void step()
+        {
+            if(sqlite3_step(stmt) != SQLITE_DONE)
+                db.throw_error("step failed");
+            sqlite3_reset(stmt);
+        }
+
+        ~sqlite_statement()
+        {
+            sqlite3_finalize(stmt);
+        }
+    };
+}
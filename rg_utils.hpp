@@ -2,8 +2,38 @@
 
 namespace redgene
 {
+    //32 bit FNV-1a hash, used to derive stable per column stream ids
+    inline uint_fast32_t fnv1a_hash(const string& str)
+    {
+        uint32_t hash = 2166136261u;
+        for(auto chr : str)
+        {
+            hash ^= static_cast<uint8_t>(chr);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    //64 bit FNV-1a hash of a byte range
+    inline uint_fast64_t fnv1a_hash64(const char* data, const size_t size)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for(size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    //seed of a column's key permutation, distinct per table.column under one run seed
+    inline uint_fast64_t column_seed(const uint_fast64_t seed, const string& table_name, const string& col_name)
+    {
+        return mix64(seed ^ fnv1a_hash64(col_name.data(), col_name.size())) ^ fnv1a_hash(table_name);
+    }
+
     template <typename UIntType = uint_fast64_t>
-    class rand_str_generator
+    class rand_str_generator : public arena_object
     {
     private:
         map<UIntType, string>* rand_str_warehouse = nullptr;
@@ -25,16 +55,16 @@ namespace redgene
             bypass_warehouse(bypass_warehouse)
         {
             if(!bypass_warehouse)
-                rand_str_warehouse = new map<UIntType, string>();
+                rand_str_warehouse = arena_new<map<UIntType, string>>();
             if(is_variable_length && str_length <= 6)
                 is_variable_length = false;
             
-            str_prng = new mt19937_64;
-            rand_var_len = new uniform_int_distribution<uint_fast16_t>
+            str_prng = arena_new<mt19937_64>();
+            rand_var_len = arena_new<uniform_int_distribution<uint_fast16_t>>
                 (var_length_base, str_length);
-            uidist = new uniform_int_distribution<uint_fast8_t>
+            uidist = arena_new<uniform_int_distribution<uint_fast8_t>>
                 (0, sizeof(alphabet)/sizeof(*alphabet)-2);
-            rand_str = new string(str_length, ' ');
+            rand_str = arena_new<string>(str_length, ' ');
         }
 
         const string& operator()(UIntType key)
@@ -67,20 +97,20 @@ namespace redgene
         ~rand_str_generator()
         {
             if(rand_str_warehouse)
-                delete rand_str_warehouse;
+                arena_delete(rand_str_warehouse);
             if(uidist)
-                delete uidist;
+                arena_delete(uidist);
             if(rand_var_len)
-                delete rand_var_len;
+                arena_delete(rand_var_len);
             if(str_prng)
-                delete str_prng;
+                arena_delete(str_prng);
             if(rand_str)
-                delete rand_str;
+                arena_delete(rand_str);
         }
     };
 
-    template <>
-    const char rand_str_generator<>::alphabet[] =
+    template <typename UIntType>
+    const char rand_str_generator<UIntType>::alphabet[] =
         "abcdefghijklmnopqrstuvwxyz"
         "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
         "0123456789,.-#'?!";
@@ -10,5 +10,7 @@
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <cstdio>
+#include <unistd.h>
 
 using namespace std;
\ No newline at end of file
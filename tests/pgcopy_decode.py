@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Round-trip decoder for redgene's "format": "pgcopy" output.
+
+Reads a PostgreSQL binary COPY file strictly by the format spec (signature, flags, header
+extension, int16 field counts, int32 length prefixed big-endian fields, int16 -1 trailer)
+and prints its rows in redgene's '|' delimited text form, so the result can be compared
+with the csv output of the same schema:
+
+    python3 tests/pgcopy_decode.py tests/pgcopy.json item out/item.pgcopy | diff - csv/item.csv
+
+Binary COPY carries no types, they come from the schema ("type", or that of the ref_col a
+key column refers to). A <table>_deltas file has the op (I, U or D) as an extra first field.
+"""
+import datetime
+import json
+import struct
+import sys
+
+SIGNATURE = b"PGCOPY\n\377\r\n\0"
+EPOCH = datetime.datetime(2000, 1, 1)
+MONTHS = ["JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"]
+
+
+def column_types(schema, table_name):
+    tables = {table["table_name"]: table for table in schema["tables"]}
+
+    def resolve(table, column_name, seen):
+        if (table, column_name) in seen:
+            raise ValueError("circular reference at %s.%s" % (table, column_name))
+        seen.add((table, column_name))
+        for column in tables[table]["columns"]:
+            if column["column_name"] == column_name:
+                if "type" in column:
+                    return column["type"]
+                return resolve(column["ref_tab"], column["ref_col"], seen)
+        raise ValueError("no column %s in %s" % (column_name, table))
+
+    return [resolve(table_name, column["column_name"], set())
+            for column in tables[table_name]["columns"]]
+
+
+class reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, size):
+        if self.pos + size > len(self.data):
+            raise ValueError("truncated at byte %d" % self.pos)
+        chunk = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return chunk
+
+    def unpack(self, fmt):
+        return struct.unpack(fmt, self.take(struct.calcsize(fmt)))[0]
+
+
+def date_text(days, micros=None):
+    when = EPOCH + datetime.timedelta(days=days, microseconds=micros or 0)
+    text = "%02d-%s-%d" % (when.day, MONTHS[when.month - 1], when.year)
+    if micros is not None:
+        text += " %02d:%02d:%02d" % (when.hour, when.minute, when.second)
+    return text
+
+
+def numeric_text(field):
+    ndigits, weight, sign, dscale = struct.unpack(">hhHH", field[:8])
+    if len(field) != 8 + 2 * ndigits:
+        raise ValueError("numeric of %d digits in %d bytes" % (ndigits, len(field)))
+    if sign not in (0x0000, 0x4000):
+        raise ValueError("numeric sign 0x%04x" % sign)
+    digits = struct.unpack(">%dH" % ndigits, field[8:])
+    if any(digit > 9999 for digit in digits):
+        raise ValueError("numeric digit out of range")
+    # value * 10^dscale as an integer, from base 10000 digits at weight, weight - 1, ...
+    scaled = 0
+    for i, digit in enumerate(digits):
+        exponent = 4 * (weight - i) + dscale
+        if exponent >= 0:
+            scaled += digit * 10 ** exponent
+        else:
+            if digit % 10 ** -exponent:
+                raise ValueError("numeric digits beyond its display scale")
+            scaled += digit // 10 ** -exponent
+    text = str(scaled).rjust(dscale + 1, "0")
+    if dscale:
+        text = text[:-dscale] + "." + text[-dscale:]
+    return ("-" if sign == 0x4000 else "") + text
+
+
+def field_text(field, type_name):
+    if field is None:
+        return ""
+    if type_name == "INT":
+        return str(struct.unpack(">q", field)[0])
+    if type_name == "REAL":
+        return "%g" % struct.unpack(">d", field)[0]
+    if type_name == "STRING":
+        return field.decode("utf-8")
+    if type_name == "DATE":
+        return date_text(struct.unpack(">i", field)[0])
+    if type_name == "TIMESTAMP":
+        micros = struct.unpack(">q", field)[0]
+        return date_text(micros // 86400000000, micros % 86400000000)
+    if type_name == "DECIMAL":
+        return numeric_text(field)
+    raise ValueError("unknown type " + type_name)
+
+
+def decode(data, types, out):
+    rd = reader(data)
+    if rd.take(len(SIGNATURE)) != SIGNATURE:
+        raise ValueError("bad signature")
+    flags = rd.unpack(">I")
+    if flags & (1 << 16):
+        raise ValueError("OIDs are not expected")
+    if flags & 0xFFFF0000 & ~(1 << 16):
+        raise ValueError("unknown critical flags 0x%08x" % flags)
+    rd.take(rd.unpack(">I"))
+    rows = 0
+    while True:
+        count = rd.unpack(">h")
+        if count == -1:
+            break
+        if count != len(types):
+            raise ValueError("tuple %d has %d fields, expected %d" % (rows, count, len(types)))
+        fields = []
+        for type_name in types:
+            length = rd.unpack(">i")
+            if length < -1:
+                raise ValueError("field length %d" % length)
+            fields.append(field_text(None if length == -1 else rd.take(length), type_name))
+        out.write("|".join(fields) + "\n")
+        rows += 1
+    if rd.pos != len(data):
+        raise ValueError("%d bytes after the trailer" % (len(data) - rd.pos))
+    return rows
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit("usage: pgcopy_decode.py <schema.json> <table|table_deltas> <file.pgcopy>")
+    with open(sys.argv[1]) as schema_file:
+        schema = json.load(schema_file)
+    table_name = sys.argv[2]
+    names = [table["table_name"] for table in schema["tables"]]
+    deltas = table_name not in names and table_name.endswith("_deltas")
+    types = column_types(schema, table_name[:-len("_deltas")] if deltas else table_name)
+    if deltas:
+        types = ["STRING"] + types
+    with open(sys.argv[3], "rb") as data_file:
+        data = data_file.read()
+    try:
+        rows = decode(data, types, sys.stdout)
+    except (ValueError, struct.error, UnicodeDecodeError) as error:
+        sys.exit("%s: %s" % (sys.argv[3], error))
+    sys.stderr.write("%s: %d rows\n" % (sys.argv[3], rows))
+
+
+if __name__ == "__main__":
+    main()